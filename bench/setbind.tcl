@@ -0,0 +1,38 @@
+#!/usr/bin/tclsh
+#
+# setbind.tcl --
+#
+#	Time STMT_HANDLE bind of an IN-list collection of n elements, bound
+#	again and again on one statement. Run it with the package built
+#	before and after per-statement scratch memory (TCLLIBPATH pointing
+#	at each build) to compare the same bind with and without reuse.
+#
+#	Usage: tclsh bench/setbind.tcl ?elements? ?loops? ?type? ?host port dbname user passwd?
+#
+
+package require cubrid
+
+set elements [expr {[llength $argv] > 0 ? [lindex $argv 0] : 5000}]
+set loops    [expr {[llength $argv] > 1 ? [lindex $argv 1] : 1000}]
+set type     [expr {[llength $argv] > 2 ? [lindex $argv 2] : "set"}]
+set host     [expr {[llength $argv] > 3 ? [lindex $argv 3] : "localhost"}]
+set port     [expr {[llength $argv] > 4 ? [lindex $argv 4] : 33000}]
+set dbname   [expr {[llength $argv] > 5 ? [lindex $argv 5] : "demo"}]
+set user     [expr {[llength $argv] > 6 ? [lindex $argv 6] : "public"}]
+set passwd   [expr {[llength $argv] > 7 ? [lindex $argv 7] : ""}]
+
+cubrid db -host $host -port $port -dbname $dbname -user $user -passwd $passwd
+
+set ids {}
+for {set i 0} {$i < $elements} {incr i} {
+    lappend ids $i
+}
+
+set stmt [db prepare {SELECT COUNT(*) FROM db_root WHERE 1 IN ?}]
+$stmt bind 1 $type $ids
+set usec [lindex [time {$stmt bind 1 $type $ids} $loops] 0]
+puts [format "bind %-12s %6d elements  %10.1f usec/bind" \
+          $type $elements $usec]
+$stmt close
+
+db close
@@ -0,0 +1,126 @@
+#!/usr/bin/tclsh
+#
+# tdbcforeach.tcl --
+#
+#	Compare "$db foreach" throughput of the C implemented
+#	tdbc::cubrid::resultset methods with the pure Tcl methods they
+#	replaced.
+#
+#	Usage: tclsh bench/tdbcforeach.tcl ?rows? ?host port dbname user passwd?
+#
+
+package require tdbc::cubrid
+
+set rows     [expr {[llength $argv] > 0 ? [lindex $argv 0] : 10000}]
+set host     [expr {[llength $argv] > 1 ? [lindex $argv 1] : "localhost"}]
+set port     [expr {[llength $argv] > 2 ? [lindex $argv 2] : 33000}]
+set dbname   [expr {[llength $argv] > 3 ? [lindex $argv 3] : "demo"}]
+set user     [expr {[llength $argv] > 4 ? [lindex $argv 4] : "public"}]
+set passwd   [expr {[llength $argv] > 5 ? [lindex $argv 5] : ""}]
+
+#
+# The result set as it was before nextlist/nextdict/nextresults/rowcount
+# moved into C.
+#
+oo::class create ::bench::tclresultset {
+    superclass ::tdbc::cubrid::resultset
+
+    variable -stmt
+
+    method nextresults {} {
+        set have 0
+        if {[catch {set have [${-stmt} cursor 0 CURRENT]}]} {
+            return 0
+        }
+        return $have
+    }
+
+    method nextlist var {
+        upvar 1 $var row
+        set row {}
+        set result 0
+        variable mylist
+        if {[catch {set result [${-stmt} cursor 1 CURRENT]}]} {
+            return 0
+        }
+        if {$result == 0} {
+            return 0
+        }
+        if { [catch {set mylist [ ${-stmt} fetch_row_list ]}] } {
+            return 0
+        }
+        if {[llength $mylist] == 0} {
+            return 0
+        }
+        set row $mylist
+        return 1
+    }
+
+    method nextdict var {
+        upvar 1 $var row
+        set row {}
+        set result 0
+        variable mydict
+        if {[catch {set result [${-stmt} cursor 1 CURRENT]}]} {
+            return 0
+        }
+        if {$result == 0} {
+            return 0
+        }
+        if { [catch {set mydict [ ${-stmt} fetch_row_dict ]}] } {
+            return 0
+        }
+        if {[dict size $mydict] == 0} {
+            return 0
+        }
+        set row $mydict
+        return 1
+    }
+}
+
+oo::class create ::bench::tclstatement {
+    superclass ::tdbc::cubrid::statement
+    forward resultSetCreate ::bench::tclresultset create
+}
+
+proc run {db stmtClass as} {
+    set stmt [$stmtClass create [namespace current]::s[incr ::seq] $db \
+                  {SELECT id, name, number FROM bench_foreach}]
+    set n 0
+    set usec [lindex [time {
+        $stmt foreach -as $as row {
+            incr n
+        }
+    }] 0]
+    $stmt close
+    return [list $n $usec]
+}
+
+tdbc::cubrid::connection create db $host $port $dbname $user $passwd
+
+db allrows {DROP TABLE IF EXISTS bench_foreach}
+db allrows {CREATE TABLE bench_foreach (id INT PRIMARY KEY,
+            name VARCHAR(40), number DOUBLE)}
+
+set ins [db prepare {INSERT INTO bench_foreach VALUES (:id, :name, :number)}]
+$ins paramtype id integer
+$ins paramtype number double
+db transaction {
+    for {set id 0} {$id < $rows} {incr id} {
+        set name row$id
+        set number [expr {$id * 1.5}]
+        $ins execute
+    }
+}
+$ins close
+
+foreach as {lists dicts} {
+    lassign [run db ::bench::tclstatement $as] n tclUsec
+    lassign [run db ::tdbc::cubrid::statement $as] n cUsec
+    puts [format "foreach -as %-5s %8d rows  Tcl %10.1f rows/s  C %10.1f rows/s  (x%.2f)" \
+              $as $n [expr {$n * 1e6 / $tclUsec}] [expr {$n * 1e6 / $cUsec}] \
+              [expr {double($tclUsec) / $cUsec}]]
+}
+
+db allrows {DROP TABLE IF EXISTS bench_foreach}
+db close
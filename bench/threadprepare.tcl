@@ -0,0 +1,68 @@
+#!/usr/bin/tclsh
+#
+# threadprepare.tcl --
+#
+#	Measure prepare/close throughput of STMT_HANDLE with 1, 2, 4, ...
+#	threads, each thread on its own connection. Statement registration
+#	is thread local, so the rate should grow with the thread count until
+#	the server becomes the limit.
+#
+#	Usage: tclsh bench/threadprepare.tcl ?maxthreads? ?loops? ?host port dbname user passwd?
+#
+
+package require Thread
+
+set maxthreads [expr {[llength $argv] > 0 ? [lindex $argv 0] : 64}]
+set loops    [expr {[llength $argv] > 1 ? [lindex $argv 1] : 2000}]
+set host     [expr {[llength $argv] > 2 ? [lindex $argv 2] : "localhost"}]
+set port     [expr {[llength $argv] > 3 ? [lindex $argv 3] : 33000}]
+set dbname   [expr {[llength $argv] > 4 ? [lindex $argv 4] : "demo"}]
+set user     [expr {[llength $argv] > 5 ? [lindex $argv 5] : "public"}]
+set passwd   [expr {[llength $argv] > 6 ? [lindex $argv 6] : ""}]
+
+proc run {nthreads} {
+    global loops host port dbname user passwd
+
+    set threads {}
+    for {set i 0} {$i < $nthreads} {incr i} {
+        set tid [thread::create -joinable]
+        thread::send $tid [list set auto_path $::auto_path]
+        thread::send $tid {package require cubrid}
+        thread::send $tid [list cubrid db -host $host -port $port \
+                               -dbname $dbname -user $user -passwd $passwd]
+        lappend threads $tid
+    }
+
+    set script [list apply {{loops} {
+        for {set n 0} {$n < $loops} {incr n} {
+            [db prepare {SELECT 1}] close
+        }
+    }} $loops]
+
+    set start [clock microseconds]
+    foreach tid $threads {
+        thread::send -async $tid $script ::done($tid)
+    }
+    foreach tid $threads {
+        if {![info exists ::done($tid)]} {
+            vwait ::done($tid)
+        }
+    }
+    set usec [expr {[clock microseconds] - $start}]
+
+    foreach tid $threads {
+        thread::send $tid {db close}
+        thread::release $tid
+        thread::join $tid
+    }
+    array unset ::done
+
+    return $usec
+}
+
+for {set nthreads 1} {$nthreads <= $maxthreads} {incr nthreads $nthreads} {
+    set usec [run $nthreads]
+    set total [expr {$nthreads * $loops}]
+    puts [format "%3d threads  %8d prepare/close  %10.1f per second" \
+              $nthreads $total [expr {$total * 1e6 / $usec}]]
+}
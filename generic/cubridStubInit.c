@@ -4,7 +4,7 @@
  *	Stubs tables for the foreign CUBRID libraries so that
  *	Tcl extensions can use them without the linker's knowing about them.
  *
- * @CREATED@ 2017-05-12 11:56:09Z by genExtStubs.tcl from cubridStubDefs.txt
+ * @CREATED@ 2026-10-19 07:23:58Z by genExtStubs.tcl from cubridStubDefs.txt
  *
  *-----------------------------------------------------------------------------
  */
@@ -50,31 +50,52 @@ static const char *const cubridSymbolNames[] = {
     "cci_get_db_version",
     "cci_get_autocommit",
     "cci_set_autocommit",
+    "cci_get_err_msg",
+    "cci_set_holdability",
+    "cci_get_holdability",
+    "cci_set_isolation_level",
+    "cci_set_lock_timeout",
     "cci_get_db_parameter",
     "cci_set_db_parameter",
     "cci_end_tran",
+    "cci_savepoint",
     "cci_get_last_insert_id",
     "cci_prepare",
+    "cci_get_bind_num",
+    "cci_get_param_info",
+    "cci_param_info_free",
     "cci_row_count",
     "cci_clob_new",
     "cci_clob_read",
     "cci_clob_write",
     "cci_clob_free",
+    "cci_clob_size",
     "cci_blob_new",
     "cci_blob_read",
     "cci_blob_write",
     "cci_blob_free",
+    "cci_blob_size",
     "cci_bind_param",
     "cci_execute",
+    "cci_next_result",
     "cci_cursor",
     "cci_fetch",
     "cci_get_data",
     "cci_get_result_info",
     "cci_close_req_handle",
+    "cci_set_max_row",
+    "cci_schema_info",
     "cci_set_make",
     "cci_set_get",
     "cci_set_size",
+    "cci_set_element_type",
     "cci_set_free",
+    "cci_set_allocators",
+    "cci_bind_param_array_size",
+    "cci_bind_param_array",
+    "cci_execute_array",
+    "cci_execute_result",
+    "cci_query_result_free",
     NULL
     /* @END@ */
 };
@@ -3,11 +3,14 @@ extern "C" {
 #endif
 
 #include <tcl.h>
+#include <tclOO.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <limits.h>
 #include "cas_cci.h"
 #include "broker_cas_error.h"
 #include "cubridStubs.h"
@@ -29,9 +32,48 @@ extern DLLEXPORT int Cubrid_Init(Tcl_Interp *interp);
 struct CUBRIDDATA {
     int connection;
     Tcl_Interp *interp;
+    Tcl_HashTable schemaCache; /* HANDLE schema results, by arguments */
+    Tcl_HashTable pageCache;   /* HANDLE paginate statements, by SQL */
+    int txDepth;               /* nesting of HANDLE transaction scripts */
+
+    /*
+     * Connection state as last set or read. The get commands answer from
+     * here unless -refresh is given.
+     */
+    int autocommit;
+    int isolation;     /* TRAN_* level, 0 if not read yet */
+    int lockTimeout;   /* milliseconds, valid if haveLockTimeout */
+    int haveLockTimeout;
+    int holdable;
+    int bitFormat;     /* CUBRID_BITS_BYTES or CUBRID_BITS_TEXT */
+    int lobFormat;     /* CUBRID_LOBS_VALUE or CUBRID_LOBS_LOCATOR */
+    int maxRows;       /* -maxrows of new statements, 0 for no limit */
+    int detached;      /* set by cubrid::detach, the command delete keeps
+                        * the connection open */
+    struct CUBRIDStmt *stmts; /* open statements, closed with the connection */
+    struct CubridLobConn *lobConn; /* of the locators, NULL until one is made */
 };
 
 typedef struct CUBRIDDATA CUBRIDDATA;
+typedef struct CubridLobConn CubridLobConn;
+
+/*
+ * How BIT and VARBIT values are fetched: the bytes as a bytearray, or a
+ * string of '0' and '1' characters.
+ */
+#define CUBRID_BITS_BYTES 0
+#define CUBRID_BITS_TEXT 1
+
+static const char *bitFormatStrs[] = {"bytes", "text", NULL};
+
+/*
+ * How CLOB and BLOB values are fetched: read with the row, or as a
+ * cubridlob locator object read when it is used.
+ */
+#define CUBRID_LOBS_VALUE 0
+#define CUBRID_LOBS_LOCATOR 1
+
+static const char *lobFormatStrs[] = {"value", "locator", NULL};
 
 struct CLOBDataLink {
     T_CCI_CLOB clob;
@@ -52,8 +94,24 @@ typedef struct BLOBDataLink BLOBDataLink;
  */
 struct CUBRIDStmt {
     int request;
+    CUBRIDDATA *pDb;
     CLOBDataLink *cloblink;
     BLOBDataLink *bloblink;
+    int paramCount;  /* -1 until parameter info is asked for */
+    int *paramTypes; /* cubridTypes index of each ? marker */
+    char *scratch;   /* bind work memory, see CubridScratch */
+    size_t scratchSize;
+    int rowCount;    /* rows of the current result set, -1 if none */
+    int position;    /* cursor row, 0 before the first, rowCount + 1 after
+                      * the last, -1 if not known */
+    int maxRows;     /* -maxrows, 0 for no limit */
+    int truncated;   /* the result set had more than maxRows rows */
+
+    Tcl_Interp *interp;
+    Tcl_Command cmd;
+    Tcl_HashEntry *entry;     /* in the thread's statement hash table */
+    struct CUBRIDStmt *prev;  /* in pDb->stmts */
+    struct CUBRIDStmt *next;
 };
 
 typedef struct CUBRIDStmt CUBRIDStmt;
@@ -61,12 +119,31 @@ typedef struct CUBRIDStmt CUBRIDStmt;
 typedef struct ThreadSpecificData {
     int initialized;                  /* initialization flag */
     Tcl_HashTable *cubrid_hashtblPtr; /* per thread hash table. */
+    int threadId;                     /* process unique, names statements */
     int stmt_count;
 } ThreadSpecificData;
 
 static Tcl_ThreadDataKey dataKey;
 
-TCL_DECLARE_MUTEX(myMutex);
+/*
+ * Statement names are cubrid_stat<threadId>_<stmt_count>, unique in the
+ * process (so they survive cubrid::detach) without a shared counter.
+ */
+static int threadCounter = 0;
+
+/*
+ * Connections between cubrid::detach and cubrid::attach, by token.
+ */
+typedef struct CubridDetached {
+    CUBRIDDATA *pDb;
+    int stmtCount;
+    char **stmtNames; /* in pDb->stmts order */
+} CubridDetached;
+
+TCL_DECLARE_MUTEX(detachMutex);
+static Tcl_HashTable detachedTable;
+static int detachedInitialized = 0;
+static int detachedCounter = 0;
 
 /*
  * For Tcl_LoadFile
@@ -75,1723 +152,5405 @@ static Tcl_Mutex cubridMutex;
 static int cubridRefCount = 0;
 static Tcl_LoadHandle cubridLoadHandle = NULL;
 
-#define CUBRID_LOB_READ_BUF_SIZE 1048576
+/*
+ * Atomic operations on the ints shared by all threads. Compilers without
+ * GCC or MSVC builtins fall back to a mutex.
+ */
+#if !defined(__GNUC__) && defined(_MSC_VER)
+#include <intrin.h>
+#elif !defined(__GNUC__)
+TCL_DECLARE_MUTEX(atomicMutex);
+#endif
+
+static int CubridAtomicLoad(int *ptr) {
+#if defined(__GNUC__)
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+    return (int)_InterlockedOr((volatile long *)ptr, 0);
+#else
+    int value;
+
+    Tcl_MutexLock(&atomicMutex);
+    value = *ptr;
+    Tcl_MutexUnlock(&atomicMutex);
+    return value;
+#endif
+}
+
+static int CubridAtomicCAS(int *ptr, int expected, int desired) {
+#if defined(__GNUC__)
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+    return _InterlockedCompareExchange((volatile long *)ptr, desired,
+                                       expected) == expected;
+#else
+    int done = 0;
+
+    Tcl_MutexLock(&atomicMutex);
+    if (*ptr == expected) {
+        *ptr = desired;
+        done = 1;
+    }
+    Tcl_MutexUnlock(&atomicMutex);
+    return done;
+#endif
+}
+
+/*
+ * Add delta to *ptr and return the new value.
+ */
+static int CubridAtomicAdd(int *ptr, int delta) {
+    int value;
+
+    do {
+        value = CubridAtomicLoad(ptr);
+    } while (!CubridAtomicCAS(ptr, value, value + delta));
+
+    return value + delta;
+}
 
 /*
- * cubrid_str2bit is from CUBRID database driver source code
+ * Allocators given to CCI with cci_set_allocators, chosen by the
+ * TCLCUBRID_ALLOCATOR environment variable when the CCI library is first
+ * loaded, and kept for the life of the process:
+ *   system  the C library, no hook is installed (default)
+ *   tcl     Tcl_AttemptAlloc, the thread cached allocator of threaded Tcl
+ *   pool    per thread free lists of size classes, over malloc
+ * Each block starts with a header holding its size, for realloc and for
+ * the cubrid::allocstats counters.
  */
-static char *cubrid_str2bit(char *str) {
-    int i = 0, len = 0, t = 0;
-    char *buf = NULL;
-    int shift = 8;
+enum CubridAllocMode {
+    CUBRID_ALLOC_SYSTEM,
+    CUBRID_ALLOC_TCL,
+    CUBRID_ALLOC_POOL
+};
+
+static const char *cubridAllocModes[] = {"system", "tcl", "pool", NULL};
+static int cubridAllocMode = -1; /* not decided until the first load */
+
+typedef struct CubridAllocHeader {
+    size_t size;   /* bytes asked for */
+    int sizeClass; /* pool size class, -1 if not from the pool */
+} CubridAllocHeader;
+
+#define CUBRID_POOL_CLASSES 8    /* blocks of 32 to 4096 bytes */
+#define CUBRID_POOL_MIN_SIZE 32
+#define CUBRID_POOL_KEEP 64      /* free blocks kept per class and thread */
+
+typedef struct CubridPoolCache {
+    CubridAllocHeader *freeList[CUBRID_POOL_CLASSES];
+    int freeCount[CUBRID_POOL_CLASSES];
+} CubridPoolCache;
+
+static Tcl_ThreadDataKey poolKey;
+
+typedef struct CubridAllocStats {
+    Tcl_WideInt mallocs;
+    Tcl_WideInt callocs;
+    Tcl_WideInt reallocs;
+    Tcl_WideInt frees;
+    Tcl_WideInt poolHits; /* blocks taken from a pool free list */
+    Tcl_WideInt inUse;    /* bytes allocated and not freed */
+} CubridAllocStats;
+
+static CubridAllocStats cubridAllocStats;
+
+static void CubridStatAdd(Tcl_WideInt *counter, Tcl_WideInt n) {
+#if defined(__GNUC__)
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    _InterlockedExchangeAdd64((volatile __int64 *)counter, n);
+#else
+    Tcl_MutexLock(&atomicMutex);
+    *counter += n;
+    Tcl_MutexUnlock(&atomicMutex);
+#endif
+}
+
+static Tcl_WideInt CubridStatGet(Tcl_WideInt *counter) {
+#if defined(__GNUC__)
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return _InterlockedExchangeAdd64((volatile __int64 *)counter, 0);
+#else
+    Tcl_WideInt value;
+
+    Tcl_MutexLock(&atomicMutex);
+    value = *counter;
+    Tcl_MutexUnlock(&atomicMutex);
+    return value;
+#endif
+}
+
+static void *CubridMalloc(size_t size) {
+    CubridAllocHeader *h;
+    size_t total = size + sizeof(CubridAllocHeader);
+    int sizeClass = -1;
+
+    if (cubridAllocMode == CUBRID_ALLOC_POOL &&
+        total <= (size_t)CUBRID_POOL_MIN_SIZE << (CUBRID_POOL_CLASSES - 1)) {
+        CubridPoolCache *cache = (CubridPoolCache *)Tcl_GetThreadData(
+            &poolKey, sizeof(CubridPoolCache));
+
+        sizeClass = 0;
+        while (((size_t)CUBRID_POOL_MIN_SIZE << sizeClass) < total) {
+            sizeClass++;
+        }
+
+        h = cache->freeList[sizeClass];
+        if (h) {
+            cache->freeList[sizeClass] = *(CubridAllocHeader **)(h + 1);
+            cache->freeCount[sizeClass]--;
+            CubridStatAdd(&cubridAllocStats.poolHits, 1);
+        } else {
+            h = (CubridAllocHeader *)malloc((size_t)CUBRID_POOL_MIN_SIZE
+                                            << sizeClass);
+        }
+    } else if (cubridAllocMode == CUBRID_ALLOC_TCL) {
+        h = (CubridAllocHeader *)attemptckalloc(total);
+    } else {
+        h = (CubridAllocHeader *)malloc(total);
+    }
 
-    if (str == NULL)
+    if (h == NULL) {
         return NULL;
-    len = strlen(str);
+    }
+
+    h->size = size;
+    h->sizeClass = sizeClass;
+    CubridStatAdd(&cubridAllocStats.mallocs, 1);
+    CubridStatAdd(&cubridAllocStats.inUse, (Tcl_WideInt)size);
 
-    if (0 == len % shift)
-        t = 1;
+    return h + 1;
+}
 
-    buf = (char *)malloc(len / shift + 1 + 1);
-    memset(buf, 0, len / shift + 1 + 1);
+static void CubridFree(void *ptr) {
+    CubridAllocHeader *h;
 
-    for (i = 0; i < len; i++) {
-        if (str[len - i - 1] == '1') {
-            buf[len / shift - i / shift - t] |= (1 << (i % shift));
-        } else if (str[len - i - 1] == '0') {
-            // nothing
+    if (ptr == NULL) {
+        return;
+    }
+
+    h = (CubridAllocHeader *)ptr - 1;
+    CubridStatAdd(&cubridAllocStats.frees, 1);
+    CubridStatAdd(&cubridAllocStats.inUse, -(Tcl_WideInt)h->size);
+
+    if (h->sizeClass >= 0) {
+        CubridPoolCache *cache = (CubridPoolCache *)Tcl_GetThreadData(
+            &poolKey, sizeof(CubridPoolCache));
+
+        if (cache->freeCount[h->sizeClass] < CUBRID_POOL_KEEP) {
+            *(CubridAllocHeader **)(h + 1) = cache->freeList[h->sizeClass];
+            cache->freeList[h->sizeClass] = h;
+            cache->freeCount[h->sizeClass]++;
         } else {
-            return NULL;
+            free(h);
         }
+    } else if (cubridAllocMode == CUBRID_ALLOC_TCL) {
+        ckfree((char *)h);
+    } else {
+        free(h);
     }
-    return buf;
 }
 
-void CUBRID_Thread_Exit(ClientData clientdata) {
+static void *CubridRealloc(void *ptr, size_t size) {
+    CubridAllocHeader *h;
+    void *newPtr;
+
+    if (ptr == NULL) {
+        return CubridMalloc(size);
+    }
+
+    CubridStatAdd(&cubridAllocStats.reallocs, 1);
+    h = (CubridAllocHeader *)ptr - 1;
+
     /*
-     * This extension records hash table info in ThreadSpecificData,
-     * so we need delete it when we exit a thread.
+     * A pool block that is still big enough is kept.
      */
-    Tcl_HashSearch search;
-    Tcl_HashEntry *entry;
+    if (h->sizeClass >= 0 &&
+        size + sizeof(CubridAllocHeader) <=
+            (size_t)CUBRID_POOL_MIN_SIZE << h->sizeClass) {
+        CubridStatAdd(&cubridAllocStats.inUse,
+                      (Tcl_WideInt)size - (Tcl_WideInt)h->size);
+        h->size = size;
+        return ptr;
+    }
 
-    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
-        &dataKey, sizeof(ThreadSpecificData));
+    newPtr = CubridMalloc(size);
+    if (newPtr == NULL) {
+        return NULL;
+    }
 
-    if (tsdPtr->cubrid_hashtblPtr) {
-        for (entry = Tcl_FirstHashEntry(tsdPtr->cubrid_hashtblPtr, &search);
-             entry != NULL;
-             entry = Tcl_FirstHashEntry(tsdPtr->cubrid_hashtblPtr, &search)) {
-            // Try to delete entry
-            Tcl_DeleteHashEntry(entry);
+    memcpy(newPtr, ptr, h->size < size ? h->size : size);
+    CubridFree(ptr);
+
+    return newPtr;
+}
+
+static void *CubridCalloc(size_t nmemb, size_t size) {
+    void *ptr;
+
+    if (size != 0 && nmemb > (size_t)-1 / size) {
+        return NULL;
+    }
+
+    CubridStatAdd(&cubridAllocStats.callocs, 1);
+    ptr = CubridMalloc(nmemb * size);
+    if (ptr) {
+        memset(ptr, 0, nmemb * size);
+    }
+
+    return ptr;
+}
+
+/*
+ * Give the free blocks of this thread's pool back to the C library.
+ */
+static void CubridPoolDrain(void) {
+    CubridPoolCache *cache = (CubridPoolCache *)Tcl_GetThreadData(
+        &poolKey, sizeof(CubridPoolCache));
+    CubridAllocHeader *h;
+    int i;
+
+    for (i = 0; i < CUBRID_POOL_CLASSES; i++) {
+        while ((h = cache->freeList[i]) != NULL) {
+            cache->freeList[i] = *(CubridAllocHeader **)(h + 1);
+            free(h);
         }
+        cache->freeCount[i] = 0;
+    }
+}
 
-        Tcl_DeleteHashTable(tsdPtr->cubrid_hashtblPtr);
-        ckfree(tsdPtr->cubrid_hashtblPtr);
+/*
+ * Install the CCI allocators after the library is loaded. The mode is
+ * read once; a later load installs the same allocators again.
+ */
+static int CubridInstallAllocators(Tcl_Interp *interp) {
+    if (cubridAllocMode < 0) {
+        const char *mode = Tcl_GetVar2(interp, "env", "TCLCUBRID_ALLOCATOR",
+                                       TCL_GLOBAL_ONLY);
+        Tcl_Obj *modeObj;
+        int index = CUBRID_ALLOC_SYSTEM;
+
+        if (mode != NULL && *mode != '\0') {
+            modeObj = Tcl_NewStringObj(mode, -1);
+            Tcl_IncrRefCount(modeObj);
+            if (Tcl_GetIndexFromObj(interp, modeObj, cubridAllocModes,
+                                    "allocator", 0, &index) != TCL_OK) {
+                Tcl_DecrRefCount(modeObj);
+                return TCL_ERROR;
+            }
+            Tcl_DecrRefCount(modeObj);
+        }
+
+        cubridAllocMode = index;
+    }
+
+    if (cubridAllocMode == CUBRID_ALLOC_SYSTEM) {
+        return TCL_OK;
+    }
+
+    if (cci_set_allocators(CubridMalloc, CubridFree, CubridRealloc,
+                           CubridCalloc) < 0) {
+        Tcl_SetResult(interp, (char *)"cci_set_allocators failed", NULL);
+        return TCL_ERROR;
     }
+
+    return TCL_OK;
 }
 
 /*
- * Handle cubrid command delete, unload library.
+ * Take a reference on the CCI library, loading it for the first one.
+ * Only the load and unload take cubridMutex.
  */
-static void DbDeleteCmd(void *db) {
-    CUBRIDDATA *pDb = (CUBRIDDATA *)db;
-    T_CCI_ERROR cci_error;
+static int CubridLibraryRetain(Tcl_Interp *interp) {
+    int count = CubridAtomicLoad(&cubridRefCount);
 
-    if (pDb->connection > 0) {
-        cci_disconnect(pDb->connection, &cci_error);
-        pDb->connection = 0;
+    while (count > 0) {
+        if (CubridAtomicCAS(&cubridRefCount, count, count + 1)) {
+            return TCL_OK;
+        }
+        count = CubridAtomicLoad(&cubridRefCount);
     }
 
-    Tcl_Free((char *)pDb);
-    pDb = 0;
+    Tcl_MutexLock(&cubridMutex);
+    if (CubridAtomicLoad(&cubridRefCount) == 0) {
+        if ((cubridLoadHandle = CubridInitStubs(interp)) == NULL) {
+            Tcl_MutexUnlock(&cubridMutex);
+            return TCL_ERROR;
+        }
+
+        if (CubridInstallAllocators(interp) != TCL_OK) {
+            Tcl_FSUnloadFile(NULL, cubridLoadHandle);
+            cubridLoadHandle = NULL;
+            Tcl_MutexUnlock(&cubridMutex);
+            return TCL_ERROR;
+        }
+    }
+    CubridAtomicAdd(&cubridRefCount, 1);
+    Tcl_MutexUnlock(&cubridMutex);
+
+    return TCL_OK;
+}
+
+/*
+ * Drop a reference on the CCI library, unloading it with the last one.
+ */
+static void CubridLibraryRelease(void) {
+    int count = CubridAtomicLoad(&cubridRefCount);
+
+    while (count > 1) {
+        if (CubridAtomicCAS(&cubridRefCount, count, count - 1)) {
+            return;
+        }
+        count = CubridAtomicLoad(&cubridRefCount);
+    }
 
     Tcl_MutexLock(&cubridMutex);
-    if (--cubridRefCount == 0) {
+    if (CubridAtomicAdd(&cubridRefCount, -1) == 0) {
         Tcl_FSUnloadFile(NULL, cubridLoadHandle);
         cubridLoadHandle = NULL;
     }
     Tcl_MutexUnlock(&cubridMutex);
 }
 
+#define CUBRID_LOB_READ_BUF_SIZE 1048576
+
 /*
- * STMT_HANDLE command function
+ * Type names used by STMT_HANDLE bind, columntype and paramtypes.
+ * If several names map to one CUBRID type, the first one is reported.
  */
-static int CUBRID_STMT(void *cd, Tcl_Interp *interp, int objc,
-                       Tcl_Obj *const *objv) {
-    CUBRIDDATA *pDb = (CUBRIDDATA *)cd;
-    CUBRIDStmt *pStmt;
-    Tcl_HashEntry *hashEntryPtr;
-    int choice;
-    int rc = TCL_OK;
-    char *mHandle;
+typedef struct CubridTypeInfo {
+    const char *name;
+    T_CCI_U_TYPE utype;
+} CubridTypeInfo;
 
-    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
-        &dataKey, sizeof(ThreadSpecificData));
+#define CUBRID_TYPE_VARCHAR 1 /* index of "varchar" below */
+#define CUBRID_TYPE_BINARY 4  /* index of "binary", "varbinary" follows */
 
-    if (tsdPtr->initialized == 0) {
-        tsdPtr->initialized = 1;
-        tsdPtr->cubrid_hashtblPtr =
-            (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
-        Tcl_InitHashTable(tsdPtr->cubrid_hashtblPtr, TCL_STRING_KEYS);
+/*
+ * A typed collection ("set:integer") keeps the cubridTypes index of the
+ * element type, plus one, above the index of the collection type.
+ */
+#define CUBRID_TYPE_ELEM_SHIFT 8
+#define CUBRID_TYPE_BASE(t) ((t) & ((1 << CUBRID_TYPE_ELEM_SHIFT) - 1))
+#define CUBRID_TYPE_ELEM(t) (((t) >> CUBRID_TYPE_ELEM_SHIFT) - 1)
+
+static const CubridTypeInfo cubridTypes[] = {
+    {"char", CCI_U_TYPE_CHAR},
+    {"varchar", CCI_U_TYPE_STRING},
+    {"bit", CCI_U_TYPE_BIT},
+    {"varbit", CCI_U_TYPE_VARBIT},
+    {"binary", CCI_U_TYPE_BIT},
+    {"varbinary", CCI_U_TYPE_VARBIT},
+    {"numeric", CCI_U_TYPE_NUMERIC},
+    {"integer", CCI_U_TYPE_INT},
+    {"smallint", CCI_U_TYPE_SHORT},
+    {"float", CCI_U_TYPE_FLOAT},
+    {"real", CCI_U_TYPE_FLOAT},
+    {"double", CCI_U_TYPE_DOUBLE},
+    {"monetary", CCI_U_TYPE_MONETARY},
+    {"date", CCI_U_TYPE_DATE},
+    {"time", CCI_U_TYPE_TIME},
+    {"timestamp", CCI_U_TYPE_TIMESTAMP},
+    {"timestamptz", CCI_U_TYPE_TIMESTAMPTZ},
+    {"timestampltz", CCI_U_TYPE_TIMESTAMPLTZ},
+    {"bigint", CCI_U_TYPE_BIGINT},
+    {"datetime", CCI_U_TYPE_DATETIME},
+    {"datetimetz", CCI_U_TYPE_DATETIMETZ},
+    {"datetimeltz", CCI_U_TYPE_DATETIMELTZ},
+    {"clob", CCI_U_TYPE_CLOB},
+    {"blob", CCI_U_TYPE_BLOB},
+    {"set", CCI_U_TYPE_SET},
+    {"multiset", CCI_U_TYPE_MULTISET},
+    {"sequence", CCI_U_TYPE_SEQUENCE},
+    {"enum", CCI_U_TYPE_ENUM},
+    {"json", CCI_U_TYPE_JSON},
+    {"null", CCI_U_TYPE_NULL},
+    {NULL, CCI_U_TYPE_NULL}
+};
+
+/*
+ * Map an extended type (TCCT TTTT, see cas_cci.h) from column or parameter
+ * info to an index in cubridTypes, or -1 if the type is unknown.
+ */
+static int CubridTypeIndex(int ext_type) {
+    T_CCI_U_TYPE utype;
+    int i;
+
+    if (CCI_IS_SET_TYPE(ext_type)) {
+        utype = CCI_U_TYPE_SET;
+    } else if (CCI_IS_MULTISET_TYPE(ext_type)) {
+        utype = CCI_U_TYPE_MULTISET;
+    } else if (CCI_IS_SEQUENCE_TYPE(ext_type)) {
+        utype = CCI_U_TYPE_SEQUENCE;
+    } else {
+        utype = (T_CCI_U_TYPE)CCI_GET_COLLECTION_DOMAIN(ext_type);
     }
 
-    static const char *STMT_strs[] = {
-        "bind",
-        "execute",
-        "cursor",
-        "fetch_row_list",
-        "fetch_row_dict",
-        "columns",
-        "columntype",
-        "close",
-        0
-    };
+    if (utype == CCI_U_TYPE_NULL) {
+        return -1;
+    }
 
-    enum STMT_enum {
-        STMT_BIND,
-        STMT_EXECUTE,
-        STMT_CURSOR,
-        STMT_FETCH_ROW_LIST,
-        STMT_FETCH_ROW_DICT,
-        STMT_COLUMNS,
-        STMT_COLUMNTYPE,
-        STMT_CLOSE
-    };
+    for (i = 0; cubridTypes[i].name != NULL; i++) {
+        if (cubridTypes[i].utype == utype) {
+            return i;
+        }
+    }
 
-    if (objc < 2) {
-        Tcl_WrongNumArgs(interp, 1, objv, "SUBCOMMAND ...");
-        return TCL_ERROR;
+    return -1;
+}
+
+static const char *CubridTypeName(int ext_type) {
+    int i = CubridTypeIndex(ext_type);
+
+    return (i < 0) ? "" : cubridTypes[i].name;
+}
+
+static int CubridIsCollection(T_CCI_U_TYPE utype) {
+    return utype == CCI_U_TYPE_SET || utype == CCI_U_TYPE_MULTISET ||
+           utype == CCI_U_TYPE_SEQUENCE;
+}
+
+/*
+ * Look up a type name given to STMT_HANDLE bind. The index is cached in
+ * the Tcl_Obj, so binding in a loop does not compare strings.
+ *
+ * A collection type may name its element type, as in "set:integer".
+ */
+static int CubridGetTypeFromObj(Tcl_Interp *interp, Tcl_Obj *objPtr,
+                                int *typeIndexPtr) {
+    const char *name = Tcl_GetString(objPtr);
+    const char *colon = strchr(name, ':');
+    Tcl_Obj *partPtr;
+    T_CCI_U_TYPE utype;
+    int collIndex, elemIndex;
+    int res;
+
+    if (colon == NULL) {
+        return Tcl_GetIndexFromObjStruct(interp, objPtr, cubridTypes,
+                                         sizeof(CubridTypeInfo), "type", 0,
+                                         typeIndexPtr);
     }
 
-    if (Tcl_GetIndexFromObj(interp, objv[1], STMT_strs, "option", 0, &choice)) {
+    partPtr = Tcl_NewStringObj(name, (Tcl_Size)(colon - name));
+    Tcl_IncrRefCount(partPtr);
+    res = Tcl_GetIndexFromObjStruct(interp, partPtr, cubridTypes,
+                                    sizeof(CubridTypeInfo), "type", 0,
+                                    &collIndex);
+    Tcl_DecrRefCount(partPtr);
+    if (res != TCL_OK) {
         return TCL_ERROR;
     }
 
-    /*
-     * Get back CUBRIDStmt pointer from our hash table
-     */
-    mHandle = Tcl_GetStringFromObj(objv[0], 0);
-    hashEntryPtr = Tcl_FindHashEntry(tsdPtr->cubrid_hashtblPtr, mHandle);
-    if (!hashEntryPtr) {
-        if (interp) {
-            Tcl_Obj *resultObj = Tcl_GetObjResult(interp);
-            Tcl_AppendStringsToObj(resultObj, "invalid handle ", mHandle,
-                                   (char *)NULL);
-        }
+    if (!CubridIsCollection(cubridTypes[collIndex].utype)) {
+        Tcl_SetObjResult(interp,
+                         Tcl_ObjPrintf("type \"%s\" has no element type",
+                                       cubridTypes[collIndex].name));
+        return TCL_ERROR;
+    }
 
+    partPtr = Tcl_NewStringObj(colon + 1, -1);
+    Tcl_IncrRefCount(partPtr);
+    res = Tcl_GetIndexFromObjStruct(interp, partPtr, cubridTypes,
+                                    sizeof(CubridTypeInfo), "element type",
+                                    0, &elemIndex);
+    Tcl_DecrRefCount(partPtr);
+    if (res != TCL_OK) {
         return TCL_ERROR;
     }
 
-    pStmt = Tcl_GetHashValue(hashEntryPtr);
-    if (pStmt->request < 0) {
+    utype = cubridTypes[elemIndex].utype;
+    if (CubridIsCollection(utype) || utype == CCI_U_TYPE_CLOB ||
+        utype == CCI_U_TYPE_BLOB || utype == CCI_U_TYPE_NULL) {
+        Tcl_SetObjResult(interp,
+                         Tcl_ObjPrintf("bad element type \"%s\"",
+                                       cubridTypes[elemIndex].name));
         return TCL_ERROR;
     }
 
-    switch ((enum STMT_enum)choice) {
-    case STMT_BIND: {
-        int res;
-        int index;
-        char *type;
-        Tcl_Size len;
-        T_CCI_U_TYPE utype;
-        T_CCI_A_TYPE atype;
-        T_CCI_ERROR cci_error;
-        char *res_buf;
-        int int_val;
-        int64_t int64_val;
-        T_CCI_BIT bit;
-        double double_val;
-        T_CCI_CLOB clob = NULL;
-        T_CCI_BLOB blob = NULL;
-        CLOBDataLink *clob_current, *clob_next;
-        BLOBDataLink *blob_current, *blob_next;
-        char *temp_data_char;
+    *typeIndexPtr = collIndex | ((elemIndex + 1) << CUBRID_TYPE_ELEM_SHIFT);
+    return TCL_OK;
+}
 
-        /*
-         * For Collection Types
-         */
-        char **set_array = NULL;
-        int *set_null = NULL;
-        Tcl_Obj *elementPtr = NULL;
-        char *stringPtr = NULL;
-        Tcl_Size strLength = 0;
-        T_CCI_SET set = NULL;
-        int count = 0;
+/*
+ * The text form of every nibble, for the '0'/'1' form of a bit value.
+ */
+static const char bitNibbles[16][4] = {
+    {'0', '0', '0', '0'}, {'0', '0', '0', '1'}, {'0', '0', '1', '0'},
+    {'0', '0', '1', '1'}, {'0', '1', '0', '0'}, {'0', '1', '0', '1'},
+    {'0', '1', '1', '0'}, {'0', '1', '1', '1'}, {'1', '0', '0', '0'},
+    {'1', '0', '0', '1'}, {'1', '0', '1', '0'}, {'1', '0', '1', '1'},
+    {'1', '1', '0', '0'}, {'1', '1', '0', '1'}, {'1', '1', '1', '0'},
+    {'1', '1', '1', '1'}};
 
-        if (objc == 5) {
-            if (Tcl_GetIntFromObj(interp, objv[2], &index) != TCL_OK) {
-                return TCL_ERROR;
-            }
+/*
+ * Convert len '0'/'1' characters to (len + 7) / 8 bytes in buf. The value
+ * is right aligned, as in the CUBRID drivers: the last character is the
+ * low bit of the last byte. Returns -1 for any other character.
+ */
+static int CubridBitsFromText(const char *str, Tcl_Size len,
+                              unsigned char *buf) {
+    Tcl_Size i = 0;
+    int nbytes = (int)((len + 7) / 8);
+    int n = (int)(len % 8);
+    int b;
+    unsigned int byte;
+
+    if (n == 0) {
+        n = 8;
+    }
 
-            type = Tcl_GetStringFromObj(objv[3], &len);
-            if (!type || len < 1) {
-                return TCL_ERROR;
+    for (b = 0; b < nbytes; b++) {
+        byte = 0;
+        for (; n > 0; n--, i++) {
+            if ((str[i] & ~1) != '0') {
+                return -1;
             }
-        } else {
-            Tcl_WrongNumArgs(interp, 2, objv, "index type value");
-            return TCL_ERROR;
+            byte = (byte << 1) | (unsigned int)(str[i] - '0');
         }
+        buf[b] = (unsigned char)byte;
+        n = 8;
+    }
 
-        if (strcmp(type, "char") == 0) {
-            utype = CCI_U_TYPE_CHAR;
-            atype = CCI_A_TYPE_STR;
+    return nbytes;
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf) {
-                return TCL_ERROR;
-            }
+/*
+ * The '0'/'1' form of size bytes, eight characters a byte.
+ */
+static Tcl_Obj *CubridBitsToText(const unsigned char *buf, int size) {
+    Tcl_Obj *objPtr = Tcl_NewObj();
+    char *p;
+    int b;
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "varchar") == 0) {
-            utype = CCI_U_TYPE_STRING;
-            atype = CCI_A_TYPE_STR;
+    if (size <= 0) {
+        return objPtr;
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf) {
-                return TCL_ERROR;
-            }
+    Tcl_SetObjLength(objPtr, (Tcl_Size)size * 8);
+    p = Tcl_GetString(objPtr);
+    for (b = 0; b < size; b++) {
+        memcpy(p, bitNibbles[buf[b] >> 4], 4);
+        memcpy(p + 4, bitNibbles[buf[b] & 0xf], 4);
+        p += 8;
+    }
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "bit") == 0) {
-            utype = CCI_U_TYPE_BIT;
-            atype = CCI_A_TYPE_BIT;
+    return objPtr;
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+void CUBRID_Thread_Exit(ClientData clientdata) {
+    /*
+     * This extension records hash table info in ThreadSpecificData,
+     * so we need delete it when we exit a thread.
+     */
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entry;
 
-            temp_data_char = cubrid_str2bit(res_buf);
-            if (!temp_data_char) {
-                Tcl_SetResult(interp, (char *)"bit conversion fail", NULL);
-                return TCL_ERROR;
-            }
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
+        &dataKey, sizeof(ThreadSpecificData));
 
-            bit.buf = temp_data_char;
-            bit.size = len / 8 + 1;
+    if (tsdPtr->cubrid_hashtblPtr) {
+        for (entry = Tcl_FirstHashEntry(tsdPtr->cubrid_hashtblPtr, &search);
+             entry != NULL;
+             entry = Tcl_FirstHashEntry(tsdPtr->cubrid_hashtblPtr, &search)) {
+            // Try to delete entry
+            ((CUBRIDStmt *)Tcl_GetHashValue(entry))->entry = NULL;
+            Tcl_DeleteHashEntry(entry);
+        }
 
-            res = cci_bind_param(pStmt->request, index, atype, &bit, utype, 0);
-            free(temp_data_char);
-        } else if (strcmp(type, "varbit") == 0) {
-            utype = CCI_U_TYPE_VARBIT;
-            atype = CCI_A_TYPE_BIT;
+        Tcl_DeleteHashTable(tsdPtr->cubrid_hashtblPtr);
+        ckfree(tsdPtr->cubrid_hashtblPtr);
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    CubridPoolDrain();
+}
 
-            temp_data_char = cubrid_str2bit(res_buf);
-            if (!temp_data_char) {
-                Tcl_SetResult(interp, (char *)"bit conversion fail", NULL);
-                return TCL_ERROR;
-            }
+/*
+ * Drop the cached HANDLE schema results of a connection.
+ */
+static void CubridSchemaInvalidate(CUBRIDDATA *pDb) {
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entry;
 
-            bit.buf = temp_data_char;
-            bit.size = len / 8 + 1;
+    for (entry = Tcl_FirstHashEntry(&pDb->schemaCache, &search); entry != NULL;
+         entry = Tcl_NextHashEntry(&search)) {
+        Tcl_DecrRefCount((Tcl_Obj *)Tcl_GetHashValue(entry));
+        Tcl_DeleteHashEntry(entry);
+    }
+}
 
-            res = cci_bind_param(pStmt->request, index, atype, &bit, utype, 0);
-            free(temp_data_char);
-        } else if (strcmp(type, "numeric") == 0) {
-            utype = CCI_U_TYPE_NUMERIC;
-            atype = CCI_A_TYPE_STR;
+/*
+ * Statements that change what HANDLE schema reports.
+ */
+static int CubridIsSchemaChange(T_CCI_CUBRID_STMT stmt_type) {
+    switch (stmt_type) {
+    case CUBRID_STMT_ALTER_CLASS:
+    case CUBRID_STMT_CREATE_CLASS:
+    case CUBRID_STMT_CREATE_INDEX:
+    case CUBRID_STMT_DROP_CLASS:
+    case CUBRID_STMT_DROP_INDEX:
+    case CUBRID_STMT_RENAME_CLASS:
+    case CUBRID_STMT_ALTER_INDEX:
+        return 1;
+    default:
+        return 0;
+    }
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+static void StmtDeleteCmd(void *stmt);
+static void CubridPageCacheClear(CUBRIDDATA *pDb);
+static void CubridLobConnClose(CUBRIDDATA *pDb);
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "integer") == 0) {
-            utype = CCI_U_TYPE_INT;
-            atype = CCI_A_TYPE_INT;
+/*
+ * Handle cubrid command delete: close the statements of the connection,
+ * disconnect and unload library.
+ */
+static void DbDeleteCmd(void *db) {
+    CUBRIDDATA *pDb = (CUBRIDDATA *)db;
+    CUBRIDStmt *pStmt, *pNext;
+    T_CCI_ERROR cci_error;
 
-            if (Tcl_GetIntFromObj(interp, objv[4], &int_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    if (pDb->detached) {
+        return;
+    }
 
-            res = cci_bind_param(pStmt->request, index, atype, &int_val, utype,
-                                 0);
-        } else if (strcmp(type, "smallint") == 0) {
-            utype = CCI_U_TYPE_SHORT;
-            atype = CCI_A_TYPE_INT;
+    for (pStmt = pDb->stmts; pStmt != NULL; pStmt = pNext) {
+        pNext = pStmt->next;
+        Tcl_DeleteCommandFromToken(pStmt->interp, pStmt->cmd);
+    }
+    CubridPageCacheClear(pDb);
+    Tcl_DeleteHashTable(&pDb->pageCache);
+    CubridLobConnClose(pDb);
 
-            if (Tcl_GetIntFromObj(interp, objv[4], &int_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    if (pDb->connection > 0) {
+        cci_disconnect(pDb->connection, &cci_error);
+        pDb->connection = 0;
+    }
 
-            res = cci_bind_param(pStmt->request, index, atype, &int_val, utype,
-                                 0);
-        } else if (strcmp(type, "float") == 0) {
-            utype = CCI_U_TYPE_FLOAT;
-            atype = CCI_A_TYPE_FLOAT;
+    CubridSchemaInvalidate(pDb);
+    Tcl_DeleteHashTable(&pDb->schemaCache);
 
-            /*
-             * Is is OK to use double?
-             */
-            if (Tcl_GetDoubleFromObj(interp, objv[4], &double_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    /*
+     * HANDLE transaction may be running a script that closed us.
+     */
+    Tcl_EventuallyFree((char *)pDb, TCL_DYNAMIC);
+    pDb = 0;
 
-            res = cci_bind_param(pStmt->request, index, atype, &double_val,
-                                 utype, 0);
-        } else if (strcmp(type, "real") == 0) {
-            /*
-             * In CUBRID database, FLOAT and REAL are used interchangeably.
-             */
-            utype = CCI_U_TYPE_FLOAT;
-            atype = CCI_A_TYPE_FLOAT;
+    CubridLibraryRelease();
+}
 
-            /*
-             * Is is OK to use double?
-             */
-            if (Tcl_GetDoubleFromObj(interp, objv[4], &double_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+/*
+ * Get the thread specific data, creating our statement hash table for
+ * this thread if it does not exist yet.
+ */
+static ThreadSpecificData *CubridGetThreadData(void) {
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
+        &dataKey, sizeof(ThreadSpecificData));
 
-            res = cci_bind_param(pStmt->request, index, atype, &double_val,
-                                 utype, 0);
-        } else if (strcmp(type, "double") == 0) {
-            utype = CCI_U_TYPE_DOUBLE;
-            atype = CCI_A_TYPE_DOUBLE;
+    if (tsdPtr->initialized == 0) {
+        tsdPtr->initialized = 1;
+        tsdPtr->cubrid_hashtblPtr =
+            (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
+        Tcl_InitHashTable(tsdPtr->cubrid_hashtblPtr, TCL_STRING_KEYS);
+        tsdPtr->threadId = CubridAtomicAdd(&threadCounter, 1) - 1;
+        tsdPtr->stmt_count = 0;
+    }
 
-            if (Tcl_GetDoubleFromObj(interp, objv[4], &double_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    return tsdPtr;
+}
 
-            res = cci_bind_param(pStmt->request, index, atype, &double_val,
-                                 utype, 0);
-        } else if (strcmp(type, "monetary") == 0) {
-            utype = CCI_U_TYPE_MONETARY;
-            atype = CCI_A_TYPE_DOUBLE;
+/*
+ * Get back CUBRIDStmt pointer from our hash table
+ */
+static CUBRIDStmt *CubridFindStmt(Tcl_Interp *interp, const char *mHandle,
+                                  Tcl_HashEntry **entryPtr) {
+    ThreadSpecificData *tsdPtr = CubridGetThreadData();
+    Tcl_HashEntry *hashEntryPtr;
 
-            if (Tcl_GetDoubleFromObj(interp, objv[4], &double_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    hashEntryPtr = Tcl_FindHashEntry(tsdPtr->cubrid_hashtblPtr, mHandle);
+    if (!hashEntryPtr) {
+        if (interp) {
+            Tcl_Obj *resultObj = Tcl_GetObjResult(interp);
+            Tcl_AppendStringsToObj(resultObj, "invalid handle ", mHandle,
+                                   (char *)NULL);
+        }
 
-            res = cci_bind_param(pStmt->request, index, atype, &double_val,
-                                 utype, 0);
-        } else if (strcmp(type, "date") == 0) {
-            utype = CCI_U_TYPE_DATE;
-            atype = CCI_A_TYPE_STR;
+        return NULL;
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    if (entryPtr) {
+        *entryPtr = hashEntryPtr;
+    }
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "time") == 0) {
-            utype = CCI_U_TYPE_TIME;
-            atype = CCI_A_TYPE_STR;
+    return (CUBRIDStmt *)Tcl_GetHashValue(hashEntryPtr);
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+/*
+ * Format a DATE, TIME or TIMESTAMP value into tbuf (64 bytes).
+ */
+static void CubridFormatDate(T_CCI_U_TYPE type, T_CCI_DATE *date, int asDict,
+                             char *tbuf) {
+    struct tm tm1;
+
+    memset(&tm1, 0, sizeof(tm1));
+    tm1.tm_year = date->yr - 1900;
+    tm1.tm_mon = date->mon - 1;
+    tm1.tm_mday = date->day;
+
+    if (type == CCI_U_TYPE_DATE) {
+        strftime(tbuf, 64, "%Y/%m/%d", &tm1);
+    } else if (type == CCI_U_TYPE_TIME) {
+        tm1.tm_hour = date->hh;
+        tm1.tm_min = date->mm;
+        tm1.tm_sec = date->ss;
+        strftime(tbuf, 64, "%H:%M:%S", &tm1);
+    } else {
+        tm1.tm_hour = date->hh;
+        tm1.tm_min = date->mm;
+        tm1.tm_sec = date->ss;
+        strftime(tbuf, 64,
+                 asDict ? "%Y/%m/%d %H:%M:%S" : "%Y/%m/%d %H:%M:%S.00", &tm1);
+    }
+}
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "timestamp") == 0) {
-            utype = CCI_U_TYPE_TIMESTAMP;
-            atype = CCI_A_TYPE_STR;
+static Tcl_Obj *CubridNewDateObj(T_CCI_U_TYPE type, T_CCI_DATE *date,
+                                 int asDict) {
+    char tbuf[64];
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    CubridFormatDate(type, date, asDict, tbuf);
+    return Tcl_NewStringObj(tbuf, -1);
+}
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "timestamptz") == 0) {
-            utype = CCI_U_TYPE_TIMESTAMPTZ;
-            atype = CCI_A_TYPE_STR;
+/*
+ * Get element index (1 based) of a collection as a value of the element
+ * type (cci_set_element_type). A NULL element is an empty string.
+ */
+static int CubridGetSetElement(T_CCI_SET set, int index, int elemType,
+                               int asDict, Tcl_Obj **elemPtr) {
+    int ind = 0;
+    int res;
+    int int_val;
+    int64_t int64_val;
+    double double_val;
+    T_CCI_DATE date;
+    char *str;
+
+    switch (elemType) {
+    case CCI_U_TYPE_INT:
+    case CCI_U_TYPE_SHORT:
+        res = cci_set_get(set, index, CCI_A_TYPE_INT, &int_val, &ind);
+        if (res >= 0 && ind >= 0) {
+            *elemPtr = Tcl_NewIntObj(int_val);
+        }
+        break;
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    case CCI_U_TYPE_BIGINT:
+        res = cci_set_get(set, index, CCI_A_TYPE_BIGINT, &int64_val, &ind);
+        if (res >= 0 && ind >= 0) {
+            *elemPtr = Tcl_NewWideIntObj((Tcl_WideInt)int64_val);
+        }
+        break;
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "timestampltz") == 0) {
-            utype = CCI_U_TYPE_TIMESTAMPLTZ;
-            atype = CCI_A_TYPE_STR;
+    case CCI_U_TYPE_FLOAT:
+    case CCI_U_TYPE_DOUBLE:
+        res = cci_set_get(set, index, CCI_A_TYPE_DOUBLE, &double_val, &ind);
+        if (res >= 0 && ind >= 0) {
+            *elemPtr = Tcl_NewDoubleObj(double_val);
+        }
+        break;
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    case CCI_U_TYPE_DATE:
+    case CCI_U_TYPE_TIME:
+    case CCI_U_TYPE_TIMESTAMP:
+        res = cci_set_get(set, index, CCI_A_TYPE_DATE, &date, &ind);
+        if (res >= 0 && ind >= 0) {
+            *elemPtr = CubridNewDateObj((T_CCI_U_TYPE)elemType, &date, asDict);
+        }
+        break;
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "bigint") == 0) {
-            utype = CCI_U_TYPE_BIGINT;
-            atype = CCI_A_TYPE_BIGINT;
+    default:
+        res = cci_set_get(set, index, CCI_A_TYPE_STR, &str, &ind);
+        if (res >= 0 && ind >= 0) {
+            *elemPtr = Tcl_NewStringObj(str, -1);
+        }
+        break;
+    }
 
-            if (Tcl_GetWideIntFromObj(interp, objv[4], (Tcl_WideInt *) &int64_val) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    if (res < 0) {
+        return res;
+    }
 
-            res = cci_bind_param(pStmt->request, index, atype, &int64_val,
-                                 utype, 0);
-        } else if (strcmp(type, "datetime") == 0) {
-            utype = CCI_U_TYPE_DATETIME;
-            atype = CCI_A_TYPE_STR;
+    if (ind < 0) {
+        *elemPtr = Tcl_NewObj();
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    return 0;
+}
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "datetimetz") == 0) {
-            utype = CCI_U_TYPE_DATETIMETZ;
-            atype = CCI_A_TYPE_STR;
+/*
+ * The connection of the locators of a CUBRIDDATA. It is shared by the
+ * connection and its locators and holds a reference on the CCI library,
+ * so a locator can always free its CCI memory. connection is 0 once the
+ * connection is closed or detached, and the locators cannot read.
+ */
+struct CubridLobConn {
+    int refCount; /* CUBRIDDATA and locators, changed atomically */
+    int connection;
+};
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+static CubridLobConn *CubridLobConnGet(CUBRIDDATA *pDb) {
+    CubridLobConn *connPtr = pDb->lobConn;
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "datetimeltz") == 0) {
-            utype = CCI_U_TYPE_DATETIMELTZ;
-            atype = CCI_A_TYPE_STR;
+    if (connPtr == NULL) {
+        if (CubridLibraryRetain(pDb->interp) != TCL_OK) {
+            return NULL;
+        }
+        connPtr = (CubridLobConn *)ckalloc(sizeof(CubridLobConn));
+        connPtr->refCount = 1;
+        connPtr->connection = pDb->connection;
+        pDb->lobConn = connPtr;
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+    return connPtr;
+}
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "clob") == 0) {
-            utype = CCI_U_TYPE_CLOB;
-            atype = CCI_A_TYPE_CLOB;
+static void CubridLobConnRelease(CubridLobConn *connPtr) {
+    if (CubridAtomicAdd(&connPtr->refCount, -1) == 0) {
+        ckfree(connPtr);
+        CubridLibraryRelease();
+    }
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+/*
+ * The connection stops being usable for its locators.
+ */
+static void CubridLobConnClose(CUBRIDDATA *pDb) {
+    if (pDb->lobConn) {
+        pDb->lobConn->connection = 0;
+        CubridLobConnRelease(pDb->lobConn);
+        pDb->lobConn = NULL;
+    }
+}
 
-            if (len >= CUBRID_LOB_READ_BUF_SIZE) {
-                Tcl_SetResult(interp, (char *)"size is too big", NULL);
-                return TCL_ERROR;
-            }
+/*
+ * A LOB column fetched with -lobformat locator is a cubridlob object: the
+ * locator and its connection. The data is read only when the string of
+ * the object is asked for (all of it), or a part with cubrid::lob read.
+ * The string of a BLOB has one character per byte, as a bytearray does.
+ */
+typedef struct CubridLob {
+    int refCount;      /* objects sharing the locator */
+    CubridLobConn *conn;
+    T_CCI_U_TYPE type; /* CCI_U_TYPE_BLOB or CCI_U_TYPE_CLOB */
+    void *lob;         /* T_CCI_BLOB or T_CCI_CLOB */
+    int failed;        /* the string was made by a read that failed */
+} CubridLob;
+
+static void LobFreeInternalRep(Tcl_Obj *objPtr);
+static void LobDupInternalRep(Tcl_Obj *srcPtr, Tcl_Obj *dupPtr);
+static void LobUpdateString(Tcl_Obj *objPtr);
+
+static const Tcl_ObjType cubridLobType = {
+    "cubridlob",        /* name */
+    LobFreeInternalRep, /* freeIntRepProc */
+    LobDupInternalRep,  /* dupIntRepProc */
+    LobUpdateString,    /* updateStringProc */
+    NULL                /* setFromAnyProc */
+};
 
-            res = cci_clob_new(pDb->connection, &clob, &cci_error);
+#define CubridLobRep(objPtr)                                                  \
+    ((CubridLob *)(objPtr)->internalRep.twoPtrValue.ptr1)
 
-            if (res < 0) {
-                Tcl_SetResult(interp, (char *)"clob new failed", NULL);
-                return TCL_ERROR;
-            }
+static Tcl_Obj *CubridNewLobObj(CubridLobConn *connPtr, T_CCI_U_TYPE type,
+                                void *lob) {
+    Tcl_Obj *objPtr = Tcl_NewObj();
+    CubridLob *lobPtr = (CubridLob *)ckalloc(sizeof(CubridLob));
 
-            res = cci_clob_write(pDb->connection, clob, 0, len, res_buf,
-                                 &cci_error);
-            if (res < 0) {
-                Tcl_SetResult(interp, (char *)"clob write failed", NULL);
-                return TCL_ERROR;
-            }
+    CubridAtomicAdd(&connPtr->refCount, 1);
+    lobPtr->refCount = 1;
+    lobPtr->conn = connPtr;
+    lobPtr->type = type;
+    lobPtr->lob = lob;
+    lobPtr->failed = 0;
 
-            res = cci_bind_param(pStmt->request, index, atype, (void *)clob,
-                                 utype, 0);
+    Tcl_InvalidateStringRep(objPtr);
+    objPtr->internalRep.twoPtrValue.ptr1 = lobPtr;
+    objPtr->internalRep.twoPtrValue.ptr2 = NULL;
+    objPtr->typePtr = &cubridLobType;
 
-            /*
-             * store our clob info
-             */
-            clob_current = pStmt->cloblink;
-            if (clob_current == NULL) {
-                clob_current = (CLOBDataLink *)malloc(sizeof(CLOBDataLink));
-                if (!clob_current) {
-                    Tcl_SetResult(
-                        interp, (char *)"malloc clob data memory failed", NULL);
-
-                    cci_clob_free(&clob); // Free clob memory
-                    return TCL_ERROR;
-                }
+    return objPtr;
+}
 
-                clob_current->clob = clob;
-                clob_current->next = NULL;
-            } else {
-                while (clob_current->next) {
-                    clob_current = clob_current->next;
-                }
+static void LobFreeInternalRep(Tcl_Obj *objPtr) {
+    CubridLob *lobPtr = CubridLobRep(objPtr);
 
-                clob_next = (CLOBDataLink *)malloc(sizeof(CLOBDataLink));
-                if (!clob_next) {
-                    Tcl_SetResult(interp,
-                                  (char *)"malloc clob data memory next failed",
-                                  NULL);
+    if (--lobPtr->refCount <= 0) {
+        if (lobPtr->type == CCI_U_TYPE_BLOB) {
+            cci_blob_free(lobPtr->lob);
+        } else {
+            cci_clob_free(lobPtr->lob);
+        }
+        CubridLobConnRelease(lobPtr->conn);
+        ckfree(lobPtr);
+    }
+    objPtr->typePtr = NULL;
+}
 
-                    cci_clob_free(&clob); // Free clob memory
-                    return TCL_ERROR;
-                }
+static void LobDupInternalRep(Tcl_Obj *srcPtr, Tcl_Obj *dupPtr) {
+    CubridLob *lobPtr = CubridLobRep(srcPtr);
 
-                clob_next->clob = clob;
-                clob_next->next = NULL;
-                clob_current->next = clob_next;
-            }
-        } else if (strcmp(type, "blob") == 0) {
-            utype = CCI_U_TYPE_BLOB;
-            atype = CCI_A_TYPE_BLOB;
+    lobPtr->refCount++;
+    dupPtr->internalRep.twoPtrValue.ptr1 = lobPtr;
+    dupPtr->internalRep.twoPtrValue.ptr2 = NULL;
+    dupPtr->typePtr = &cubridLobType;
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf || len < 1) {
-                return TCL_ERROR;
-            }
+static long long CubridLobSize(CubridLob *lobPtr) {
+    if (lobPtr->type == CCI_U_TYPE_BLOB) {
+        return cci_blob_size(lobPtr->lob);
+    }
+    return cci_clob_size(lobPtr->lob);
+}
 
-            if (len >= CUBRID_LOB_READ_BUF_SIZE) {
-                Tcl_SetResult(interp, (char *)"size is too big", NULL);
-                return TCL_ERROR;
-            }
+/*
+ * Read up to length bytes of a LOB at offset into buf, in pieces of at
+ * most CUBRID_LOB_READ_BUF_SIZE. Returns the number of bytes read, or -1
+ * if a read fails.
+ */
+static long long CubridLobReadAt(int connection, T_CCI_U_TYPE type,
+                                 void *lob, long long offset,
+                                 long long length, char *buf) {
+    T_CCI_ERROR cci_error;
+    long long done = 0;
+    int chunk;
+    int res;
+
+    while (done < length) {
+        chunk = (int)(length - done > CUBRID_LOB_READ_BUF_SIZE
+                          ? CUBRID_LOB_READ_BUF_SIZE
+                          : length - done);
+        if (type == CCI_U_TYPE_BLOB) {
+            res = cci_blob_read(connection, lob, (long)(offset + done), chunk,
+                                buf + done, &cci_error);
+        } else {
+            res = cci_clob_read(connection, lob, (long)(offset + done), chunk,
+                                buf + done, &cci_error);
+        }
+        if (res < 0) {
+            return -1;
+        }
+        if (res == 0) {
+            break;
+        }
+        done += res;
+    }
 
-            res = cci_blob_new(pDb->connection, &blob, &cci_error);
-            if (res < 0) {
-                Tcl_SetResult(interp, (char *)"blob new failed", NULL);
-                return TCL_ERROR;
-            }
+    return done;
+}
 
-            res = cci_blob_write(pDb->connection, blob, 0, len, res_buf,
-                                 &cci_error);
-            if (res < 0) {
-                Tcl_SetResult(interp, (char *)"blob write failed", NULL);
-                return TCL_ERROR;
-            }
+/*
+ * Read from a locator: as CubridLobReadAt, or -2 if the connection is
+ * closed.
+ */
+static long long CubridLobRead(CubridLob *lobPtr, long long offset,
+                               long long length, char *buf) {
+    if (lobPtr->conn->connection <= 0) {
+        return -2;
+    }
 
-            res = cci_bind_param(pStmt->request, index, atype, (void *)blob,
-                                 utype, 0);
+    return CubridLobReadAt(lobPtr->conn->connection, lobPtr->type,
+                           lobPtr->lob, offset, length, buf);
+}
 
-            /*
-             * store our blob info
-             */
-            blob_current = pStmt->bloblink;
-            if (blob_current == NULL) {
-                blob_current = (BLOBDataLink *)malloc(sizeof(BLOBDataLink));
-                if (!blob_current) {
-                    Tcl_SetResult(
-                        interp, (char *)"malloc blob data memory failed", NULL);
-
-                    cci_blob_free(&blob); // Free blob memory
-                    return TCL_ERROR;
-                }
+/*
+ * Read the whole LOB for the string of the object. The string of a read
+ * that fails (for example after the connection is closed) is empty and
+ * the locator is marked, so STMT_HANDLE bind refuses it instead of writing
+ * the empty value back; cubrid::lob read reports the error.
+ */
+static void LobUpdateString(Tcl_Obj *objPtr) {
+    CubridLob *lobPtr = CubridLobRep(objPtr);
+    long long size = CubridLobSize(lobPtr);
+    long long len = 0;
+    long long extra = 0;
+    long long i;
+    unsigned char *buf;
+    char *p;
+
+    if (size > 0) {
+        buf = (unsigned char *)ckalloc((size_t)size + 1);
+        len = CubridLobRead(lobPtr, 0, size, (char *)buf);
+    } else {
+        buf = (unsigned char *)ckalloc(1);
+    }
+    if (size < 0 || len < 0) {
+        lobPtr->failed = 1;
+        len = 0;
+    }
 
-                blob_current->blob = blob;
-                blob_current->next = NULL;
-            } else {
-                while (blob_current->next) {
-                    blob_current = blob_current->next;
-                }
+    if (lobPtr->type == CCI_U_TYPE_CLOB) {
+        buf[len] = '\0';
+        objPtr->bytes = (char *)buf;
+        objPtr->length = (Tcl_Size)len;
+        return;
+    }
 
-                blob_next = (BLOBDataLink *)malloc(sizeof(BLOBDataLink));
-                if (!blob_next) {
-                    Tcl_SetResult(interp,
-                                  (char *)"malloc blob data memory next failed",
-                                  NULL);
+    /*
+     * One character per byte, in Tcl's UTF-8 (NUL is C0 80).
+     */
+    for (i = 0; i < len; i++) {
+        if (buf[i] == 0 || buf[i] >= 0x80) {
+            extra++;
+        }
+    }
 
-                    cci_blob_free(&blob); // Free blob memory
-                    return TCL_ERROR;
-                }
+    p = ckalloc((size_t)(len + extra) + 1);
+    objPtr->bytes = p;
+    objPtr->length = (Tcl_Size)(len + extra);
+    for (i = 0; i < len; i++) {
+        if (buf[i] == 0 || buf[i] >= 0x80) {
+            *p++ = (char)(0xC0 | (buf[i] >> 6));
+            *p++ = (char)(0x80 | (buf[i] & 0x3F));
+        } else {
+            *p++ = (char)buf[i];
+        }
+    }
+    *p = '\0';
+    ckfree(buf);
+}
 
-                blob_next->blob = blob;
-                blob_next->next = NULL;
-                blob_current->next = blob_next;
-            }
-        } else if (strcmp(type, "set") == 0) {
-            utype = CCI_U_TYPE_SET;
-            atype = CCI_A_TYPE_SET;
-
-            if (Tcl_ListObjLength(interp, objv[4], &len) != TCL_OK) {
-                return TCL_ERROR;
-            }
+/*
+ * Get the value of column i of the current row of a request handle.
+ * *valuePtr is set to NULL if the value is NULL.
+ *
+ * asDict only selects the TIMESTAMP format, so fetch_row_list and
+ * fetch_row_dict keep returning what they always did.
+ */
+static int CubridGetColumn(Tcl_Interp *interp, CUBRIDDATA *pDb, int request,
+                           int i, T_CCI_U_TYPE type, int asDict,
+                           Tcl_Obj **valuePtr) {
+    int error, ind;
+    char *res_buf;
+    int int_val;
+    int64_t int64_val;
+    double double_val;
+    T_CCI_BIT bit;
+    T_CCI_DATE date;
+    T_CCI_CLOB clob;
+    T_CCI_BLOB blob;
+    T_CCI_SET cci_set;
+    int set_size = 0;
+    int elem_type;
+    Tcl_Obj *pResultSet;
+    Tcl_Obj *elemPtr;
+    int count = 0;
+    unsigned char *bytes;
+    long long lob_size;
+    CubridLobConn *connPtr;
+    int res = 0;
+
+    *valuePtr = NULL;
+
+    switch (type) {
+    case CCI_U_TYPE_INT:
+    case CCI_U_TYPE_SHORT:
+        error = cci_get_data(request, i, CCI_A_TYPE_INT, &int_val, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            if (len <= 0) {
-                Tcl_SetResult(
-                    interp, (char *)"bind data set: list length is zero", NULL);
-                return TCL_ERROR;
-            }
+        if (ind >= 0) {
+            *valuePtr = Tcl_NewIntObj(int_val);
+        }
 
-            set_array = (char **)malloc(sizeof(char *) * len);
-            if (!set_array) {
-                Tcl_SetResult(interp,
-                              (char *)"bind data set set_array malloc failed",
-                              NULL);
-                return TCL_ERROR;
-            }
+        break;
 
-            for (count = 0; count < len; count++) {
-                set_array[count] = NULL;
-            }
+    case CCI_U_TYPE_BIGINT:
+        error = cci_get_data(request, i, CCI_A_TYPE_BIGINT, &int64_val, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            set_null = (int *)malloc(sizeof(int) * len);
-            if (!set_null) {
-                if (set_array)
-                    free(set_array);
-                Tcl_SetResult(interp,
-                              (char *)"bind data set set_null malloc failed",
-                              NULL);
-                return TCL_ERROR;
-            }
+        if (ind >= 0) {
+            *valuePtr = Tcl_NewWideIntObj(int64_val);
+        }
 
-            for (count = 0; count < len; count++) {
-                Tcl_ListObjIndex(interp, objv[4], count, &elementPtr);
-                stringPtr = Tcl_GetStringFromObj(elementPtr, &strLength);
+        break;
 
-                set_array[count] = stringPtr;
-                set_null[count] = 0;
-            }
+    case CCI_U_TYPE_FLOAT:
+    case CCI_U_TYPE_DOUBLE:
+    case CCI_U_TYPE_NUMERIC:
+    case CCI_U_TYPE_MONETARY:
+        error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            if ((res = cci_set_make(&set, CCI_U_TYPE_STRING, len, set_array,
-                                    set_null)) < 0) {
-                if (set_array)
-                    free(set_array);
-                if (set_null)
-                    free(set_null);
+        if (ind >= 0) {
+            double_val = atof(res_buf);
+            *valuePtr = Tcl_NewDoubleObj(double_val);
+        }
 
-                return TCL_ERROR;
-            }
+        break;
 
-            res = cci_bind_param(pStmt->request, index, atype, set, utype, 0);
+    case CCI_U_TYPE_DATE:
+    case CCI_U_TYPE_TIME:
+    case CCI_U_TYPE_TIMESTAMP:
+        error = cci_get_data(request, i, CCI_A_TYPE_DATE, &date, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            cci_set_free(set);
+        if (ind >= 0) {
+            *valuePtr = CubridNewDateObj(type, &date, asDict);
+        }
 
-            if (set_array)
-                free(set_array);
-            if (set_null)
-                free(set_null);
-        } else if (strcmp(type, "multiset") == 0) {
-            utype = CCI_U_TYPE_MULTISET;
-            atype = CCI_A_TYPE_SET;
+        break;
 
-            if (Tcl_ListObjLength(interp, objv[4], &len) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    case CCI_U_TYPE_BIT:
+    case CCI_U_TYPE_VARBIT:
+        error = cci_get_data(request, i, CCI_A_TYPE_BIT, &bit, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            if (len <= 0) {
-                Tcl_SetResult(interp,
-                              (char *)"bind data multiset: list length is zero",
-                              NULL);
-                return TCL_ERROR;
+        if (ind >= 0) {
+            if (pDb->bitFormat == CUBRID_BITS_TEXT) {
+                *valuePtr =
+                    CubridBitsToText((unsigned char *)bit.buf, bit.size);
+            } else {
+                *valuePtr =
+                    Tcl_NewByteArrayObj((unsigned char *)bit.buf, bit.size);
             }
+        }
 
-            set_array = (char **)malloc(sizeof(char *) * len);
-            if (!set_array) {
-                Tcl_SetResult(
-                    interp,
-                    (char *)"bind data multiset set_array malloc failed", NULL);
-                return TCL_ERROR;
-            }
+        break;
 
-            for (count = 0; count < len; count++) {
-                set_array[count] = NULL;
-            }
+    case CCI_U_TYPE_CLOB:
+        error =
+            cci_get_data(request, i, CCI_A_TYPE_CLOB, (void *)&clob, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            set_null = (int *)malloc(sizeof(int) * len);
-            if (!set_null) {
-                if (set_array)
-                    free(set_array);
-                Tcl_SetResult(
-                    interp, (char *)"bind data multiset set_null malloc failed",
-                    NULL);
+        if (ind >= 0 && pDb->lobFormat == CUBRID_LOBS_LOCATOR &&
+            (connPtr = CubridLobConnGet(pDb)) != NULL) {
+            *valuePtr = CubridNewLobObj(connPtr, type, clob);
+        } else if (ind >= 0) {
+            /*
+             * Read the whole CLOB straight into the string of a new
+             * object of its size.
+             */
+            lob_size = cci_clob_size(clob);
+            if (lob_size < 0) {
+                cci_clob_free(clob);
+                Tcl_SetResult(interp, (char *)"read clob failed", NULL);
                 return TCL_ERROR;
             }
 
-            for (count = 0; count < len; count++) {
-                Tcl_ListObjIndex(interp, objv[4], count, &elementPtr);
-                stringPtr = Tcl_GetStringFromObj(elementPtr, &strLength);
-
-                set_array[count] = stringPtr;
-                set_null[count] = 0;
-            }
-
-            if ((res = cci_set_make(&set, CCI_U_TYPE_STRING, len, set_array,
-                                    set_null)) < 0) {
-                if (set_array)
-                    free(set_array);
-                if (set_null)
-                    free(set_null);
-
+            pResultSet = Tcl_NewObj();
+            Tcl_SetObjLength(pResultSet, (Tcl_Size)lob_size);
+            lob_size = CubridLobReadAt(pDb->connection, CCI_U_TYPE_CLOB, clob,
+                                       0, lob_size, Tcl_GetString(pResultSet));
+            cci_clob_free(clob);
+            if (lob_size < 0) {
+                Tcl_IncrRefCount(pResultSet);
+                Tcl_DecrRefCount(pResultSet);
+                Tcl_SetResult(interp, (char *)"read clob failed", NULL);
                 return TCL_ERROR;
             }
 
-            res = cci_bind_param(pStmt->request, index, atype, set, utype, 0);
+            Tcl_SetObjLength(pResultSet, (Tcl_Size)lob_size);
+            *valuePtr = pResultSet;
+        }
 
-            cci_set_free(set);
+        break;
 
-            if (set_array)
-                free(set_array);
-            if (set_null)
-                free(set_null);
-        } else if (strcmp(type, "sequence") == 0) {
-            utype = CCI_U_TYPE_SEQUENCE;
-            atype = CCI_A_TYPE_SET;
+    case CCI_U_TYPE_BLOB:
+        error =
+            cci_get_data(request, i, CCI_A_TYPE_BLOB, (void *)&blob, &ind);
+        if (error < 0) {
+            Tcl_SetResult(interp, (char *)"get data failed", NULL);
+            return TCL_ERROR;
+        }
 
-            if (Tcl_ListObjLength(interp, objv[4], &len) != TCL_OK) {
+        if (ind >= 0 && pDb->lobFormat == CUBRID_LOBS_LOCATOR &&
+            (connPtr = CubridLobConnGet(pDb)) != NULL) {
+            *valuePtr = CubridNewLobObj(connPtr, type, blob);
+        } else if (ind >= 0) {
+            /*
+             * Read the whole BLOB straight into a bytearray of its size,
+             * the bytes are neither copied nor taken as UTF-8.
+             */
+            lob_size = cci_blob_size(blob);
+            if (lob_size < 0) {
+                cci_blob_free(blob);
+                Tcl_SetResult(interp, (char *)"read blob failed", NULL);
                 return TCL_ERROR;
             }
 
-            if (len <= 0) {
-                Tcl_SetResult(interp,
-                              (char *)"bind data sequence: list length is zero",
-                              NULL);
+            pResultSet = Tcl_NewByteArrayObj(NULL, 0);
+            bytes = Tcl_SetByteArrayLength(pResultSet, (Tcl_Size)lob_size);
+            lob_size = CubridLobReadAt(pDb->connection, CCI_U_TYPE_BLOB, blob,
+                                       0, lob_size, (char *)bytes);
+            cci_blob_free(blob);
+            if (lob_size < 0) {
+                Tcl_IncrRefCount(pResultSet);
+                Tcl_DecrRefCount(pResultSet);
+                Tcl_SetResult(interp, (char *)"read blob failed", NULL);
                 return TCL_ERROR;
             }
 
-            set_array = (char **)malloc(sizeof(char *) * len);
-            if (!set_array) {
-                Tcl_SetResult(
-                    interp,
-                    (char *)"bind data sequence set_array malloc failed", NULL);
-                return TCL_ERROR;
-            }
+            Tcl_SetByteArrayLength(pResultSet, (Tcl_Size)lob_size);
+            *valuePtr = pResultSet;
+        }
 
-            for (count = 0; count < len; count++) {
-                set_array[count] = NULL;
-            }
+        break;
 
-            set_null = (int *)malloc(sizeof(int) * len);
-            if (!set_null) {
-                if (set_array)
-                    free(set_array);
-                Tcl_SetResult(
-                    interp, (char *)"bind data sequence set_null malloc failed",
-                    NULL);
+    default:
+        if (CCI_IS_COLLECTION_TYPE(type)) {
+            error = cci_get_data(request, i, CCI_A_TYPE_SET, (void *)&cci_set,
+                                 &ind);
+            if (error < 0) {
+                Tcl_SetResult(interp, (char *)"get data failed", NULL);
                 return TCL_ERROR;
             }
 
-            for (count = 0; count < len; count++) {
-                Tcl_ListObjIndex(interp, objv[4], count, &elementPtr);
-                stringPtr = Tcl_GetStringFromObj(elementPtr, &strLength);
+            if (ind >= 0) {
+                set_size = cci_set_size(cci_set);
+                if (set_size < 0) {
+                    cci_set_free(cci_set);
+                    Tcl_SetResult(interp, (char *)"Set size is wrong.", NULL);
+                    return TCL_ERROR;
+                }
 
-                set_array[count] = stringPtr;
-                set_null[count] = 0;
-            }
+                elem_type = cci_set_element_type(cci_set);
+                pResultSet = Tcl_NewListObj(0, NULL);
+                for (count = 0; count < set_size; count++) {
+                    res = CubridGetSetElement(cci_set, count + 1, elem_type,
+                                              asDict, &elemPtr);
+                    if (res < 0) {
+                        Tcl_IncrRefCount(pResultSet);
+                        Tcl_DecrRefCount(pResultSet);
+                        cci_set_free(cci_set);
+                        Tcl_SetResult(interp, (char *)"Get set data fail.",
+                                      NULL);
+                        return TCL_ERROR;
+                    }
 
-            if ((res = cci_set_make(&set, CCI_U_TYPE_STRING, len, set_array,
-                                    set_null)) < 0) {
-                if (set_array)
-                    free(set_array);
-                if (set_null)
-                    free(set_null);
+                    Tcl_ListObjAppendElement(NULL, pResultSet, elemPtr);
+                }
 
+                *valuePtr = pResultSet;
+                cci_set_free(cci_set);
+            }
+        } else {
+            error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+            if (error < 0) {
+                Tcl_SetResult(interp, (char *)"get data failed", NULL);
                 return TCL_ERROR;
             }
 
-            res = cci_bind_param(pStmt->request, index, atype, set, utype, 0);
+            if (ind >= 0) {
+                *valuePtr = Tcl_NewStringObj(res_buf, -1);
+            }
+        }
 
-            cci_set_free(set);
+        break;
+    }
 
-            if (set_array)
-                free(set_array);
-            if (set_null)
-                free(set_null);
-        } else if (strcmp(type, "enum") == 0) {
-            utype = CCI_U_TYPE_STRING;
-            atype = CCI_A_TYPE_STR;
+    return TCL_OK;
+}
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf) {
-                return TCL_ERROR;
-            }
+/*
+ * Fetch the row at the cursor of a request handle and return it as a list
+ * or as a dictionary. This is the only decode path for result rows; the
+ * STMT_HANDLE fetch methods and the TDBC result set both use it.
+ *
+ * In a list a NULL value is an empty string. If a value is NULL, the
+ * returned dictionary for the row will not contain the corresponding key.
+ */
+static int CubridGetRow(Tcl_Interp *interp, CUBRIDDATA *pDb, int request,
+                        int asDict, Tcl_Obj **rowPtr) {
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    int col_count = 0;
+    int error;
+    int i;
+    Tcl_Obj *pRow;
+    Tcl_Obj *pValue;
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "json") == 0) {
-            utype = CCI_U_TYPE_JSON;
-            atype = CCI_A_TYPE_STR;
+    /*
+     * getting column information when the prepared statement is the
+     * SELECT query
+     */
+    col_info = cci_get_result_info(request, &stmt_type, &col_count);
+    if (col_info == NULL) {
+        Tcl_SetResult(interp, (char *)"get result info fail", NULL);
+        return TCL_ERROR;
+    }
 
-            res_buf = Tcl_GetStringFromObj(objv[4], &len);
-            if (!res_buf) {
-                return TCL_ERROR;
-            }
+    error = cci_fetch(request, &cci_error);
+    if (error < 0) {
+        Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        return TCL_ERROR;
+    }
 
-            res =
-                cci_bind_param(pStmt->request, index, atype, res_buf, utype, 0);
-        } else if (strcmp(type, "null") == 0) {
-            utype = CCI_U_TYPE_NULL;
-            atype = CCI_A_TYPE_STR;
+    pRow = Tcl_NewListObj(0, NULL);
 
-            res = cci_bind_param(pStmt->request, index, atype, NULL, utype, 0);
-        } else {
+    for (i = 1; i <= col_count; i++) {
+        if (CubridGetColumn(interp, pDb, request, i,
+                            CCI_GET_RESULT_INFO_TYPE(col_info, i), asDict,
+                            &pValue) != TCL_OK) {
+            Tcl_IncrRefCount(pRow);
+            Tcl_DecrRefCount(pRow);
             return TCL_ERROR;
         }
 
-        if (res < 0) {
-            Tcl_SetResult(interp, (char *)"bind data failed", NULL);
-            return TCL_ERROR;
+        if (asDict) {
+            if (pValue) {
+                Tcl_DictObjPut(
+                    NULL, pRow,
+                    Tcl_NewStringObj(CCI_GET_RESULT_INFO_NAME(col_info, i), -1),
+                    pValue);
+            }
+        } else {
+            Tcl_ListObjAppendElement(NULL, pRow, pValue ? pValue : Tcl_NewObj());
         }
-
-        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
-        break;
     }
 
-    case STMT_EXECUTE: {
-        Tcl_Obj *return_obj;
-        T_CCI_ERROR cci_error;
-        int res;
-        CLOBDataLink *clob_current, *clob_next;
-        BLOBDataLink *blob_current, *blob_next;
+    *rowPtr = pRow;
+    return TCL_OK;
+}
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
-            return TCL_ERROR;
+/*
+ * Get the text of column i of the fetched row into dsPtr (which is reset),
+ * the same text fetch_row_list returns. Numbers, dates and strings are
+ * formatted without a Tcl_Obj; other types go through CubridGetColumn.
+ * *isNullPtr is set for NULL.
+ */
+static int CubridGetColumnText(Tcl_Interp *interp, CUBRIDDATA *pDb,
+                               int request, int i, T_CCI_U_TYPE type,
+                               Tcl_DString *dsPtr, int *isNullPtr) {
+    char *res_buf;
+    char tbuf[TCL_DOUBLE_SPACE > 64 ? TCL_DOUBLE_SPACE : 64];
+    T_CCI_DATE date;
+    Tcl_Obj *valuePtr;
+    Tcl_Size len;
+    int error, ind;
+
+    Tcl_DStringSetLength(dsPtr, 0);
+    *isNullPtr = 0;
+
+    switch (type) {
+    case CCI_U_TYPE_FLOAT:
+    case CCI_U_TYPE_DOUBLE:
+    case CCI_U_TYPE_NUMERIC:
+    case CCI_U_TYPE_MONETARY:
+        error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+        if (error >= 0 && ind >= 0) {
+            Tcl_PrintDouble(NULL, atof(res_buf), tbuf);
+            Tcl_DStringAppend(dsPtr, tbuf, -1);
         }
+        break;
 
-        res = cci_execute(pStmt->request, 0, 0, &cci_error);
-        if (res < 0) {
-            return_obj = Tcl_NewBooleanObj(0);
-        } else {
-            return_obj = Tcl_NewBooleanObj(1);
+    case CCI_U_TYPE_DATE:
+    case CCI_U_TYPE_TIME:
+    case CCI_U_TYPE_TIMESTAMP:
+        error = cci_get_data(request, i, CCI_A_TYPE_DATE, &date, &ind);
+        if (error >= 0 && ind >= 0) {
+            CubridFormatDate(type, &date, 0, tbuf);
+            Tcl_DStringAppend(dsPtr, tbuf, -1);
         }
+        break;
 
-        /*
-         * After we execute prepared statement, try to free CLOB/BLOB memory.
-         */
-        if (pStmt->cloblink) {
-            clob_current = pStmt->cloblink;
-            while (clob_current) {
-                clob_next = clob_current->next;
-                cci_clob_free(clob_current->clob);
-                if (clob_current)
-                    free(clob_current);
-                clob_current = NULL;
+    case CCI_U_TYPE_BIT:
+    case CCI_U_TYPE_VARBIT:
+    case CCI_U_TYPE_CLOB:
+    case CCI_U_TYPE_BLOB:
+        goto useObj;
 
-                clob_current = clob_next;
-            }
+    default:
+        if (CCI_IS_COLLECTION_TYPE(type)) {
+            goto useObj;
         }
 
-        if (pStmt->bloblink) {
-            blob_current = pStmt->bloblink;
-            while (clob_current) {
-                blob_next = blob_current->next;
-                cci_blob_free(blob_current->blob);
-                if (blob_current)
-                    free(blob_current);
-                blob_current = NULL;
-
-                blob_current = blob_next;
-            }
+        error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+        if (error >= 0 && ind >= 0) {
+            Tcl_DStringAppend(dsPtr, res_buf, -1);
         }
-
-        Tcl_SetObjResult(interp, return_obj);
         break;
     }
 
-    case STMT_CURSOR: {
-        int offset = 0;
-        char *pos = NULL;
-        Tcl_Size len = 0;
-        T_CCI_CURSOR_POS origin;
-        T_CCI_ERROR cci_error;
-        int error;
-        char *errorStr = NULL;
+    if (error < 0) {
+        Tcl_SetResult(interp, (char *)"get data failed", NULL);
+        return TCL_ERROR;
+    }
 
-        if (objc == 4) {
-            if (Tcl_GetIntFromObj(interp, objv[2], &offset) != TCL_OK) {
-                return TCL_ERROR;
-            }
+    *isNullPtr = (ind < 0);
+    return TCL_OK;
 
-            pos = Tcl_GetStringFromObj(objv[3], &len);
-            if (!pos || len < 1) {
-                return TCL_ERROR;
-            }
+useObj:
+    if (CubridGetColumn(interp, pDb, request, i, type, 0, &valuePtr) !=
+        TCL_OK) {
+        return TCL_ERROR;
+    }
 
-            /*
-             * CCI_CURSOR_FIRST = 0,
-             * CCI_CURSOR_CURRENT = 1,
-             * CCI_CURSOR_LAST = 2
-             */
-            if (strcmp(pos, "FIRST") == 0) {
-                origin = CCI_CURSOR_FIRST;
-            } else if (strcmp(pos, "CURRENT") == 0) {
-                origin = CCI_CURSOR_CURRENT;
-            } else if (strcmp(pos, "LAST") == 0) {
-                origin = CCI_CURSOR_LAST;
-            } else {
-                return TCL_ERROR;
+    *isNullPtr = (valuePtr == NULL);
+    if (valuePtr) {
+        Tcl_IncrRefCount(valuePtr);
+        res_buf = Tcl_GetStringFromObj(valuePtr, &len);
+        Tcl_DStringAppend(dsPtr, res_buf, len);
+        Tcl_DecrRefCount(valuePtr);
+    }
+
+    return TCL_OK;
+}
+
+/*
+ * Append one CSV (RFC 4180 quoting) or TSV (backslash escapes) field.
+ */
+static void CubridAppendField(Tcl_DString *dsPtr, const char *str,
+                              Tcl_Size len, int tsv) {
+    const char *p;
+    const char *run = str;
+    const char *end = str + len;
+    const char *escape;
+
+    if (tsv) {
+        for (p = str; p < end; p++) {
+            switch (*p) {
+            case '\\':
+                escape = "\\\\";
+                break;
+            case '\t':
+                escape = "\\t";
+                break;
+            case '\n':
+                escape = "\\n";
+                break;
+            case '\r':
+                escape = "\\r";
+                break;
+            default:
+                continue;
             }
-        } else {
-            Tcl_WrongNumArgs(interp, 2, objv, "offset pos");
-            return TCL_ERROR;
+            Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(p - run));
+            Tcl_DStringAppend(dsPtr, escape, 2);
+            run = p + 1;
         }
+        Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(end - run));
+        return;
+    }
 
-        error = cci_cursor(pStmt->request, offset, origin, &cci_error);
-        if (error == CCI_ER_NO_MORE_DATA) {
-            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
-            return TCL_OK;
+    for (p = str; p < end; p++) {
+        if (*p == ',' || *p == '"' || *p == '\n' || *p == '\r') {
+            break;
         }
+    }
 
-        if (error < 0) {
-            errorStr = cci_error.err_msg;
-            Tcl_SetResult(interp, errorStr, NULL);
+    if (p == end) {
+        Tcl_DStringAppend(dsPtr, str, len);
+        return;
+    }
 
-            return TCL_ERROR;
+    Tcl_DStringAppend(dsPtr, "\"", 1);
+    for (p = str; p < end; p++) {
+        if (*p == '"') {
+            Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(p + 1 - run));
+            run = p;
         }
+    }
+    Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(end - run));
+    Tcl_DStringAppend(dsPtr, "\"", 1);
+}
 
-        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
-        break;
+/*
+ * Ask CCI for the type of each ? marker once and keep the names on the
+ * statement. Markers the server does not describe are reported as varchar,
+ * which is how the TDBC driver used to bind every parameter.
+ */
+static void CubridLoadParamTypes(CUBRIDStmt *pStmt) {
+    T_CCI_PARAM_INFO *param_info = NULL;
+    T_CCI_ERROR cci_error;
+    int count, info_count;
+    int i, typeIndex;
+
+    if (pStmt->paramCount >= 0) {
+        return;
     }
 
-    case STMT_FETCH_ROW_LIST: {
-        T_CCI_COL_INFO *col_info;
-        T_CCI_CUBRID_STMT stmt_type;
-        T_CCI_U_TYPE type;
-        T_CCI_ERROR cci_error;
-        int i = 0;
-        int col_count = 0;
-        int error, ind;
-        char *errorStr = NULL;
-        Tcl_Obj *pResultStr;
-        char *res_buf;
-        int int_val;
-        int64_t int64_val;
-        double double_val;
-        T_CCI_BIT bit;
-        T_CCI_DATE date;
-        struct tm tm1;
-        char tbuf[64];
-        T_CCI_CLOB clob;
-        T_CCI_BLOB blob;
-        T_CCI_SET cci_set;
-        int set_size = 0;
-        Tcl_Obj *pResultSet;
-        int count = 0;
-        char *set_buffer = NULL;
-        char buffer[CUBRID_LOB_READ_BUF_SIZE];
-        int res = 0;
+    count = cci_get_bind_num(pStmt->request);
+    if (count <= 0) {
+        pStmt->paramCount = 0;
+        return;
+    }
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
-            return TCL_ERROR;
+    pStmt->paramTypes = (int *)ckalloc(sizeof(int) * count);
+    pStmt->paramCount = count;
+
+    info_count = cci_get_param_info(pStmt->request, &param_info, &cci_error);
+    for (i = 0; i < count; i++) {
+        typeIndex = -1;
+        if (param_info != NULL && i < info_count) {
+            typeIndex =
+                CubridTypeIndex(CCI_GET_PARAM_INFO_TYPE(param_info, i + 1));
+        }
+        if (typeIndex < 0) {
+            typeIndex = CUBRID_TYPE_VARCHAR;
         }
+        pStmt->paramTypes[i] = typeIndex;
+    }
 
-        pResultStr = Tcl_NewListObj(0, NULL);
+    if (param_info != NULL) {
+        cci_param_info_free(param_info);
+    }
+}
 
-        /*
-         * getting column information when the prepared statement is the
-         * SELECT query
-         */
-        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
-        if (col_info == NULL) {
-            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
-            return TCL_ERROR;
-        }
+/*
+ * Free the CLOB/BLOB handles created for bound parameters, they are only
+ * needed until the statement is executed.
+ */
+static void CubridFreeLobLinks(CUBRIDStmt *pStmt) {
+    CLOBDataLink *clob_current, *clob_next;
+    BLOBDataLink *blob_current, *blob_next;
+
+    clob_current = pStmt->cloblink;
+    while (clob_current) {
+        clob_next = clob_current->next;
+        cci_clob_free(clob_current->clob);
+        free(clob_current);
+        clob_current = clob_next;
+    }
+    pStmt->cloblink = NULL;
+
+    blob_current = pStmt->bloblink;
+    while (blob_current) {
+        blob_next = blob_current->next;
+        cci_blob_free(blob_current->blob);
+        free(blob_current);
+        blob_current = blob_next;
+    }
+    pStmt->bloblink = NULL;
+}
 
-        error = cci_fetch(pStmt->request, &cci_error);
-        if (error < 0) {
-            errorStr = cci_error.err_msg;
-            Tcl_SetResult(interp, errorStr, NULL);
+/*
+ * Parse a DATE, TIME or TIMESTAMP/DATETIME element of a typed collection.
+ * Dates may use - or / as separator.
+ */
+static int CubridParseDate(T_CCI_U_TYPE utype, const char *str,
+                           T_CCI_DATE *date) {
+    int yr = 0, mon = 0, day = 0, hh = 0, mm = 0, ss = 0, ms = 0;
+    int n;
 
-            return TCL_ERROR;
+    memset(date, 0, sizeof(*date));
+
+    if (utype == CCI_U_TYPE_TIME) {
+        n = sscanf(str, "%d:%d:%d", &hh, &mm, &ss);
+        if (n != 3) {
+            return 0;
+        }
+    } else {
+        n = sscanf(str, "%d%*[-/]%d%*[-/]%d %d:%d:%d.%d", &yr, &mon, &day, &hh,
+                   &mm, &ss, &ms);
+        if (n < 3) {
+            return 0;
         }
+    }
 
-        for (i = 1; i <= col_count; i++) {
-            type = CCI_GET_RESULT_INFO_TYPE(col_info, i);
+    date->yr = yr;
+    date->mon = mon;
+    date->day = day;
+    date->hh = hh;
+    date->mm = mm;
+    date->ss = ss;
+    date->ms = ms;
+    return 1;
+}
 
-            switch (type) {
-            case CCI_U_TYPE_INT:
-            case CCI_U_TYPE_SHORT:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_INT,
-                                     &int_val, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+/*
+ * Get size bytes of scratch memory of a statement. The largest buffer is
+ * kept until the statement is closed, so binding a collection again does
+ * not allocate; its contents are not preserved.
+ */
+static char *CubridScratch(CUBRIDStmt *pStmt, size_t size) {
+    if (size > pStmt->scratchSize) {
+        if (pStmt->scratch) {
+            ckfree(pStmt->scratch);
+        }
+        pStmt->scratch = ckalloc(size);
+        pStmt->scratchSize = size;
+    }
 
-                if (ind < 0) {
-                    // We got a NULL
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewIntObj(int_val));
-                }
+    return pStmt->scratch;
+}
 
-                break;
+/*
+ * Make a collection of elemIndex typed elements (cubridTypes index, or -1
+ * for strings). Numbers and dates are passed to cci_set_make in their C
+ * type; other types, and an untyped collection, as strings. An empty
+ * element of a typed number or date collection is NULL.
+ *
+ * The value and indicator arrays live in the statement scratch memory.
+ */
+static int CubridMakeSet(Tcl_Interp *interp, CUBRIDStmt *pStmt,
+                         int elemIndex, Tcl_Size len, Tcl_Obj **elemPtrs,
+                         T_CCI_SET *setPtr) {
+    T_CCI_U_TYPE utype = CCI_U_TYPE_STRING;
+    size_t elemSize = sizeof(char *);
+    size_t valuesSize;
+    char *values;
+    int *nulls;
+    Tcl_Size count;
+    Tcl_Size slen;
+    Tcl_WideInt wide_val;
+    double double_val;
+    int res = TCL_OK;
+
+    if (elemIndex >= 0) {
+        switch (cubridTypes[elemIndex].utype) {
+        case CCI_U_TYPE_INT:
+        case CCI_U_TYPE_SHORT:
+            utype = cubridTypes[elemIndex].utype;
+            elemSize = sizeof(int);
+            break;
+        case CCI_U_TYPE_BIGINT:
+            utype = CCI_U_TYPE_BIGINT;
+            elemSize = sizeof(int64_t);
+            break;
+        case CCI_U_TYPE_FLOAT:
+            utype = CCI_U_TYPE_FLOAT;
+            elemSize = sizeof(float);
+            break;
+        case CCI_U_TYPE_DOUBLE:
+            utype = CCI_U_TYPE_DOUBLE;
+            elemSize = sizeof(double);
+            break;
+        case CCI_U_TYPE_DATE:
+        case CCI_U_TYPE_TIME:
+        case CCI_U_TYPE_TIMESTAMP:
+        case CCI_U_TYPE_DATETIME:
+            utype = cubridTypes[elemIndex].utype;
+            elemSize = sizeof(T_CCI_DATE);
+            break;
+        default:
+            break;
+        }
+    }
 
-            case CCI_U_TYPE_BIGINT:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_BIGINT,
-                                     &int64_val, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    /*
+     * Indicators follow the values, at an 8 byte aligned offset.
+     */
+    valuesSize = (elemSize * len + 7) & ~(size_t)7;
+    values = CubridScratch(pStmt, valuesSize + sizeof(int) * len);
+    nulls = (int *)(values + valuesSize);
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewWideIntObj(int64_val));
-                }
+    for (count = 0; count < len && res == TCL_OK; count++) {
+        void *value = values + elemSize * count;
 
-                break;
+        nulls[count] = 0;
+        if (utype == CCI_U_TYPE_STRING) {
+            *(char **)value = Tcl_GetString(elemPtrs[count]);
+            continue;
+        }
 
-            case CCI_U_TYPE_FLOAT:
-            case CCI_U_TYPE_DOUBLE:
-            case CCI_U_TYPE_NUMERIC:
-            case CCI_U_TYPE_MONETARY:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_STR,
-                                     &res_buf, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+        /*
+         * Numbers convert without making a string rep, only a failed
+         * conversion looks for the empty (NULL) element.
+         */
+        switch (utype) {
+        case CCI_U_TYPE_INT:
+        case CCI_U_TYPE_SHORT:
+            res = Tcl_GetIntFromObj(NULL, elemPtrs[count], (int *)value);
+            break;
+        case CCI_U_TYPE_BIGINT:
+            res = Tcl_GetWideIntFromObj(NULL, elemPtrs[count], &wide_val);
+            *(int64_t *)value = (int64_t)wide_val;
+            break;
+        case CCI_U_TYPE_FLOAT:
+            res = Tcl_GetDoubleFromObj(NULL, elemPtrs[count], &double_val);
+            *(float *)value = (float)double_val;
+            break;
+        case CCI_U_TYPE_DOUBLE:
+            res = Tcl_GetDoubleFromObj(NULL, elemPtrs[count], (double *)value);
+            break;
+        default:
+            res = CubridParseDate(utype, Tcl_GetString(elemPtrs[count]),
+                                  (T_CCI_DATE *)value)
+                      ? TCL_OK
+                      : TCL_ERROR;
+            break;
+        }
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    double_val = atof(res_buf);
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewDoubleObj(double_val));
-                }
+        if (res != TCL_OK) {
+            Tcl_GetStringFromObj(elemPtrs[count], &slen);
+            if (slen == 0) {
+                memset(value, 0, elemSize);
+                nulls[count] = 1;
+                res = TCL_OK;
+            } else {
+                Tcl_SetObjResult(
+                    interp, Tcl_ObjPrintf("expected %s but got \"%s\"",
+                                          cubridTypes[elemIndex].name,
+                                          Tcl_GetString(elemPtrs[count])));
+            }
+        }
+    }
 
-                break;
+    if (res == TCL_OK &&
+        cci_set_make(setPtr, utype, (int)len, values, nulls) < 0) {
+        Tcl_SetResult(interp, (char *)"make set failed", NULL);
+        res = TCL_ERROR;
+    }
 
-            case CCI_U_TYPE_DATE:
-            case CCI_U_TYPE_TIME:
-            case CCI_U_TYPE_TIMESTAMP:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_DATE, &date,
-                                     &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    return res;
+}
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    if (type == CCI_U_TYPE_DATE) {
-                        tm1.tm_hour = 0;
-                        tm1.tm_min = 0;
-                        tm1.tm_sec = 0;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%Y/%m/%d", &tm1);
-                    } else if (type == CCI_U_TYPE_TIME) {
-                        tm1.tm_hour = date.hh;
-                        tm1.tm_min = date.mm;
-                        tm1.tm_sec = date.ss;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%H:%M:%S", &tm1);
-                    } else {
-                        tm1.tm_hour = date.hh;
-                        tm1.tm_min = date.mm;
-                        tm1.tm_sec = date.ss;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%Y/%m/%d %H:%M:%S.00",
-                                 &tm1);
-                    }
+/*
+ * Bind one value to the ? marker at index as cubridTypes[typeIndex]. A NULL
+ * valuePtr binds SQL NULL. If lenient is set, a value that cannot be
+ * converted to the native C type is sent as a string of the same CUBRID
+ * type and left to CCI to convert.
+ */
+static int CubridBindValue(Tcl_Interp *interp, CUBRIDStmt *pStmt, int index,
+                           int typeIndex, Tcl_Obj *valuePtr, int lenient) {
+    CUBRIDDATA *pDb = pStmt->pDb;
+    const char *typeName = cubridTypes[CUBRID_TYPE_BASE(typeIndex)].name;
+    T_CCI_U_TYPE utype = cubridTypes[CUBRID_TYPE_BASE(typeIndex)].utype;
+    T_CCI_A_TYPE atype = CCI_A_TYPE_STR;
+    T_CCI_ERROR cci_error;
+    Tcl_Interp *convInterp = lenient ? NULL : interp;
+    void *value = NULL;
+    char *res_buf;
+    Tcl_Size len;
+    int res;
+    int int_val;
+    Tcl_WideInt wide_val;
+    int64_t int64_val;
+    float float_val;
+    double double_val;
+    T_CCI_BIT bit;
+    unsigned char *bytes;
+    T_CCI_CLOB clob = NULL;
+    T_CCI_BLOB blob = NULL;
+    CLOBDataLink *clob_link;
+    BLOBDataLink *blob_link;
 
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj(tbuf, -1));
-                }
+    /*
+     * For Collection Types
+     */
+    Tcl_Obj **elemPtrs;
+    T_CCI_SET set = NULL;
 
-                break;
+    if (valuePtr != NULL && valuePtr->typePtr == &cubridLobType &&
+        CubridLobRep(valuePtr)->failed) {
+        Tcl_SetResult(interp, (char *)"lob locator could not be read", NULL);
+        return TCL_ERROR;
+    }
 
-            case CCI_U_TYPE_BIT:
-            case CCI_U_TYPE_VARBIT:
-                error =
-                    cci_get_data(pStmt->request, i, CCI_A_TYPE_BIT, &bit, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    if (valuePtr == NULL || utype == CCI_U_TYPE_NULL) {
+        res = cci_bind_param(pStmt->request, index, CCI_A_TYPE_STR, NULL,
+                             CCI_U_TYPE_NULL, 0);
+        goto bindDone;
+    }
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    Tcl_ListObjAppendElement(
-                        interp, pResultStr,
-                        Tcl_NewStringObj(bit.buf, bit.size));
-                }
+    switch (utype) {
+    case CCI_U_TYPE_INT:
+    case CCI_U_TYPE_SHORT:
+        if (Tcl_GetIntFromObj(convInterp, valuePtr, &int_val) == TCL_OK) {
+            atype = CCI_A_TYPE_INT;
+            value = &int_val;
+        } else if (!lenient) {
+            return TCL_ERROR;
+        }
+        break;
 
-                break;
+    case CCI_U_TYPE_BIGINT:
+        if (Tcl_GetWideIntFromObj(convInterp, valuePtr, &wide_val) == TCL_OK) {
+            int64_val = (int64_t)wide_val;
+            atype = CCI_A_TYPE_BIGINT;
+            value = &int64_val;
+        } else if (!lenient) {
+            return TCL_ERROR;
+        }
+        break;
 
-            case CCI_U_TYPE_CLOB:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_CLOB,
-                                     (void *)&clob, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    case CCI_U_TYPE_FLOAT:
+        /*
+         * In CUBRID database, FLOAT and REAL are used interchangeably.
+         * CCI_A_TYPE_FLOAT reads a float, not a double.
+         */
+        if (Tcl_GetDoubleFromObj(convInterp, valuePtr, &double_val) ==
+            TCL_OK) {
+            float_val = (float)double_val;
+            atype = CCI_A_TYPE_FLOAT;
+            value = &float_val;
+        } else if (!lenient) {
+            return TCL_ERROR;
+        }
+        break;
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    res = cci_clob_read(pDb->connection, clob, 0,
-                                        CUBRID_LOB_READ_BUF_SIZE, buffer,
-                                        &cci_error);
-                    if (res < 0) {
-                        Tcl_SetResult(interp, (char *)"read clob failed", NULL);
-                        return TCL_ERROR;
-                    }
+    case CCI_U_TYPE_DOUBLE:
+    case CCI_U_TYPE_MONETARY:
+        if (Tcl_GetDoubleFromObj(convInterp, valuePtr, &double_val) ==
+            TCL_OK) {
+            atype = CCI_A_TYPE_DOUBLE;
+            value = &double_val;
+        } else if (!lenient) {
+            return TCL_ERROR;
+        }
+        break;
 
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj(buffer, res));
-                    cci_clob_free(clob);
-                }
+    case CCI_U_TYPE_ENUM:
+        utype = CCI_U_TYPE_STRING;
+        break;
 
-                break;
+    case CCI_U_TYPE_BIT:
+    case CCI_U_TYPE_VARBIT:
+        /*
+         * bit and varbit take the '0'/'1' form, binary and varbinary the
+         * bytes of the value.
+         */
+        if (CUBRID_TYPE_BASE(typeIndex) == CUBRID_TYPE_BINARY ||
+            CUBRID_TYPE_BASE(typeIndex) == CUBRID_TYPE_BINARY + 1) {
+            bytes = Tcl_GetByteArrayFromObj(valuePtr, &len);
+            bit.buf = (char *)bytes;
+            bit.size = (int)len;
+        } else {
+            res_buf = Tcl_GetStringFromObj(valuePtr, &len);
+            bytes = (unsigned char *)CubridScratch(pStmt, (size_t)len / 8 + 1);
+            bit.buf = (char *)bytes;
+            bit.size = CubridBitsFromText(res_buf, len, bytes);
+            if (bit.size < 0) {
+                Tcl_SetResult(interp, (char *)"bit conversion fail", NULL);
+                return TCL_ERROR;
+            }
+        }
 
-            case CCI_U_TYPE_BLOB:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_BLOB,
-                                     (void *)&blob, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+        if (bit.size < 1) {
+            Tcl_SetResult(interp, (char *)"bit value is empty", NULL);
+            return TCL_ERROR;
+        }
 
-                if (ind < 0) {
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj("", -1));
-                } else {
-                    res = cci_blob_read(pDb->connection, blob, 0,
-                                        CUBRID_LOB_READ_BUF_SIZE, buffer,
-                                        &cci_error);
-                    if (res < 0) {
-                        Tcl_SetResult(interp, (char *)"read blob failed", NULL);
-                        return TCL_ERROR;
-                    }
+        res = cci_bind_param(pStmt->request, index, CCI_A_TYPE_BIT, &bit,
+                             utype, 0);
+        goto bindDone;
 
-                    Tcl_ListObjAppendElement(interp, pResultStr,
-                                             Tcl_NewStringObj(buffer, res));
-                    cci_clob_free(blob);
-                }
+    case CCI_U_TYPE_CLOB:
+    case CCI_U_TYPE_BLOB:
+        /*
+         * A BLOB is written from the bytes of a bytearray, a CLOB from the
+         * UTF-8 string.
+         */
+        if (utype == CCI_U_TYPE_BLOB) {
+            res_buf = (char *)Tcl_GetByteArrayFromObj(valuePtr, &len);
+        } else {
+            res_buf = Tcl_GetStringFromObj(valuePtr, &len);
+        }
+        if (len < 1) {
+            Tcl_SetResult(interp, (char *)"lob value is empty", NULL);
+            return TCL_ERROR;
+        }
 
-                break;
+        if (len >= CUBRID_LOB_READ_BUF_SIZE) {
+            Tcl_SetResult(interp, (char *)"size is too big", NULL);
+            return TCL_ERROR;
+        }
 
-            default:
-                if (CCI_IS_COLLECTION_TYPE(type)) {
-                    error = cci_get_data(pStmt->request, i, CCI_A_TYPE_SET,
-                                         (void *)&cci_set, &ind);
-                    if (error < 0) {
-                        Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                        return TCL_ERROR;
-                    }
+        if (utype == CCI_U_TYPE_CLOB) {
+            res = cci_clob_new(pDb->connection, &clob, &cci_error);
+            if (res < 0) {
+                Tcl_SetResult(interp, (char *)"clob new failed", NULL);
+                return TCL_ERROR;
+            }
 
-                    if (ind < 0) {
-                        Tcl_ListObjAppendElement(interp, pResultStr,
-                                                 Tcl_NewStringObj("", -1));
-                    } else {
-                        set_size = cci_set_size(cci_set);
-                        if (set_size <= 0) {
-                            Tcl_SetResult(interp, (char *)"Set size is wrong.",
-                                          NULL);
-                            return TCL_ERROR;
-                        }
-
-                        pResultSet = Tcl_NewListObj(0, NULL);
-                        for (count = 0; count < set_size; count++) {
-                            res =
-                                cci_set_get(cci_set, count + 1, CCI_A_TYPE_STR,
-                                            &set_buffer, &ind);
-                            if (res < 0) {
-                                Tcl_SetResult(
-                                    interp, (char *)"Get set data fail.", NULL);
-                                return TCL_ERROR;
-                            }
-
-                            Tcl_ListObjAppendElement(
-                                interp, pResultSet,
-                                Tcl_NewStringObj(set_buffer, -1));
-                        }
-
-                        Tcl_ListObjAppendElement(interp, pResultStr,
-                                                 pResultSet);
-                        cci_set_free(cci_set);
-                    }
-                } else {
-                    error = cci_get_data(pStmt->request, i, CCI_A_TYPE_STR,
-                                         &res_buf, &ind);
-                    if (error < 0) {
-                        Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                        return TCL_ERROR;
-                    }
+            res = cci_clob_write(pDb->connection, clob, 0, len, res_buf,
+                                 &cci_error);
+            if (res < 0) {
+                cci_clob_free(clob);
+                Tcl_SetResult(interp, (char *)"clob write failed", NULL);
+                return TCL_ERROR;
+            }
 
-                    if (ind < 0) {
-                        Tcl_ListObjAppendElement(interp, pResultStr,
-                                                 Tcl_NewStringObj("", -1));
-                    } else {
-                        Tcl_ListObjAppendElement(interp, pResultStr,
-                                                 Tcl_NewStringObj(res_buf, -1));
-                    }
-                }
+            /*
+             * store our clob info, freed after execute
+             */
+            clob_link = (CLOBDataLink *)malloc(sizeof(CLOBDataLink));
+            if (!clob_link) {
+                cci_clob_free(clob);
+                Tcl_SetResult(interp,
+                              (char *)"malloc clob data memory failed", NULL);
+                return TCL_ERROR;
+            }
+            clob_link->clob = clob;
+            clob_link->next = pStmt->cloblink;
+            pStmt->cloblink = clob_link;
 
-                break;
+            res = cci_bind_param(pStmt->request, index, CCI_A_TYPE_CLOB,
+                                 (void *)clob, utype, 0);
+        } else {
+            res = cci_blob_new(pDb->connection, &blob, &cci_error);
+            if (res < 0) {
+                Tcl_SetResult(interp, (char *)"blob new failed", NULL);
+                return TCL_ERROR;
             }
-        }
 
-        Tcl_SetObjResult(interp, pResultStr);
-        break;
-    }
+            res = cci_blob_write(pDb->connection, blob, 0, len, res_buf,
+                                 &cci_error);
+            if (res < 0) {
+                cci_blob_free(blob);
+                Tcl_SetResult(interp, (char *)"blob write failed", NULL);
+                return TCL_ERROR;
+            }
 
-    case STMT_FETCH_ROW_DICT: {
-        T_CCI_COL_INFO *col_info;
-        T_CCI_CUBRID_STMT stmt_type;
-        T_CCI_U_TYPE type;
-        char *name;
-        T_CCI_ERROR cci_error;
-        int i = 0;
-        int col_count = 0;
-        int error, ind;
-        char *errorStr = NULL;
-        Tcl_Obj *pResultStr;
-        char *res_buf;
-        int int_val;
-        int64_t int64_val;
-        double double_val;
-        T_CCI_BIT bit;
-        T_CCI_DATE date;
-        struct tm tm1;
-        char tbuf[64];
-        T_CCI_CLOB clob;
-        T_CCI_BLOB blob;
-        T_CCI_SET cci_set;
-        int set_size = 0;
-        Tcl_Obj *pResultSet;
-        int count = 0;
-        char *set_buffer = NULL;
-        char buffer[CUBRID_LOB_READ_BUF_SIZE];
-        int res = 0;
+            /*
+             * store our blob info, freed after execute
+             */
+            blob_link = (BLOBDataLink *)malloc(sizeof(BLOBDataLink));
+            if (!blob_link) {
+                cci_blob_free(blob);
+                Tcl_SetResult(interp,
+                              (char *)"malloc blob data memory failed", NULL);
+                return TCL_ERROR;
+            }
+            blob_link->blob = blob;
+            blob_link->next = pStmt->bloblink;
+            pStmt->bloblink = blob_link;
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
-            return TCL_ERROR;
+            res = cci_bind_param(pStmt->request, index, CCI_A_TYPE_BLOB,
+                                 (void *)blob, utype, 0);
         }
+        goto bindDone;
 
-        pResultStr = Tcl_NewListObj(0, NULL);
-
-        /*
-         * getting column information when the prepared statement is the
-         * SELECT query
-         */
-        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
-        if (col_info == NULL) {
-            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
+    case CCI_U_TYPE_SET:
+    case CCI_U_TYPE_MULTISET:
+    case CCI_U_TYPE_SEQUENCE:
+        if (Tcl_ListObjGetElements(interp, valuePtr, &len, &elemPtrs) !=
+            TCL_OK) {
             return TCL_ERROR;
         }
 
-        error = cci_fetch(pStmt->request, &cci_error);
-        if (error < 0) {
-            errorStr = cci_error.err_msg;
-            Tcl_SetResult(interp, errorStr, NULL);
+        if (len <= 0) {
+            Tcl_SetObjResult(
+                interp, Tcl_ObjPrintf("bind data %s: list length is zero",
+                                      typeName));
+            return TCL_ERROR;
+        }
 
+        if (CubridMakeSet(interp, pStmt, CUBRID_TYPE_ELEM(typeIndex), len,
+                          elemPtrs, &set) != TCL_OK) {
+            Tcl_SetObjResult(interp,
+                             Tcl_ObjPrintf("bind data %s: %s", typeName,
+                                           Tcl_GetStringResult(interp)));
             return TCL_ERROR;
         }
 
-        for (i = 1; i <= col_count; i++) {
-            name = CCI_GET_RESULT_INFO_NAME(col_info, i);
-            type = CCI_GET_RESULT_INFO_TYPE(col_info, i);
+        res = cci_bind_param(pStmt->request, index, CCI_A_TYPE_SET, set,
+                             utype, 0);
+        cci_set_free(set);
+        goto bindDone;
 
-            switch (type) {
-            case CCI_U_TYPE_INT:
-            case CCI_U_TYPE_SHORT:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_INT,
-                                     &int_val, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    default:
+        break;
+    }
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewIntObj(int_val));
-                }
+    if (value == NULL) {
+        value = Tcl_GetStringFromObj(valuePtr, &len);
+    }
 
-                break;
+    res = cci_bind_param(pStmt->request, index, atype, value, utype, 0);
 
-            case CCI_U_TYPE_BIGINT:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_BIGINT,
-                                     &int64_val, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+bindDone:
+    if (res < 0) {
+        Tcl_SetResult(interp, (char *)"bind data failed", NULL);
+        return TCL_ERROR;
+    }
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewWideIntObj(int64_val));
-                }
+    return TCL_OK;
+}
 
-                break;
+/*
+ * cci_cursor for a statement, keeping pStmt->position. A move out of the
+ * result set leaves the cursor before the first or after the last row,
+ * as CCI does.
+ */
+static const char *cursorOriginStrs[] = {"FIRST", "CURRENT", "LAST", NULL};
+static const T_CCI_CURSOR_POS cursorOrigins[] = {
+    CCI_CURSOR_FIRST, CCI_CURSOR_CURRENT, CCI_CURSOR_LAST};
+
+static int CubridCursor(CUBRIDStmt *pStmt, int offset, T_CCI_CURSOR_POS origin,
+                        T_CCI_ERROR *errorPtr) {
+    int known = 1;
+    int target = 0;
+    int error;
+
+    switch (origin) {
+    case CCI_CURSOR_FIRST:
+        target = offset;
+        break;
+    case CCI_CURSOR_CURRENT:
+        known = (pStmt->position >= 0);
+        target = pStmt->position + offset;
+        break;
+    case CCI_CURSOR_LAST:
+        known = (pStmt->rowCount >= 0);
+        target = pStmt->rowCount - offset + 1;
+        break;
+    }
 
-            case CCI_U_TYPE_FLOAT:
-            case CCI_U_TYPE_DOUBLE:
-            case CCI_U_TYPE_NUMERIC:
-            case CCI_U_TYPE_MONETARY:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_STR,
-                                     &res_buf, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    /*
+     * The server sends one row more than -maxrows to show the result is
+     * truncated, that row is not part of the result set. Every move is
+     * made absolute, past the extra row if it leaves the result set, so
+     * CCI's cursor is always where position says. Without a known
+     * position there is no safe relative move.
+     */
+    if (pStmt->truncated) {
+        if (!known) {
+            return CCI_ER_NO_MORE_DATA;
+        }
+        origin = CCI_CURSOR_FIRST;
+        offset = target > pStmt->rowCount ? pStmt->rowCount + 2 : target;
+    }
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    double_val = atof(res_buf);
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewDoubleObj(double_val));
-                }
+    error = cci_cursor(pStmt->request, offset, origin, errorPtr);
+    if (error == CCI_ER_NO_MORE_DATA && known) {
+        if (target < 1) {
+            target = 0;
+        } else if (pStmt->rowCount >= 0) {
+            target = pStmt->rowCount + 1;
+        } else {
+            known = 0;
+        }
+    } else if (error < 0 && error != CCI_ER_NO_MORE_DATA) {
+        known = 0;
+    }
+    pStmt->position = known ? target : -1;
 
-                break;
+    return error;
+}
 
-            case CCI_U_TYPE_DATE:
-            case CCI_U_TYPE_TIME:
-            case CCI_U_TYPE_TIMESTAMP:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_DATE, &date,
-                                     &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+/*
+ * Read a -maxrows value: 0 for no limit, or the number of rows.
+ */
+static int CubridGetMaxRows(Tcl_Interp *interp, Tcl_Obj *objPtr,
+                            int *maxRowsPtr) {
+    int maxRows;
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    if (type == CCI_U_TYPE_DATE) {
-                        tm1.tm_hour = 0;
-                        tm1.tm_min = 0;
-                        tm1.tm_sec = 0;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%Y/%m/%d", &tm1);
-                    } else if (type == CCI_U_TYPE_TIME) {
-                        tm1.tm_hour = date.hh;
-                        tm1.tm_min = date.mm;
-                        tm1.tm_sec = date.ss;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%H:%M:%S", &tm1);
-                    } else {
-                        tm1.tm_hour = date.hh;
-                        tm1.tm_min = date.mm;
-                        tm1.tm_sec = date.ss;
-                        tm1.tm_year = date.yr - 1900;
-                        tm1.tm_mon = date.mon - 1;
-                        tm1.tm_mday = date.day;
-                        strftime(tbuf, sizeof(tbuf), "%Y/%m/%d %H:%M:%S", &tm1);
-                    }
+    if (Tcl_GetIntFromObj(interp, objPtr, &maxRows) != TCL_OK) {
+        return TCL_ERROR;
+    }
 
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewStringObj(tbuf, -1));
-                }
+    if (maxRows < 0 || maxRows == INT_MAX) {
+        Tcl_SetResult(interp, (char *)"max rows must be >= 0", NULL);
+        return TCL_ERROR;
+    }
 
-                break;
+    *maxRowsPtr = maxRows;
+    return TCL_OK;
+}
 
-            case CCI_U_TYPE_BIT:
-            case CCI_U_TYPE_VARBIT:
-                error =
-                    cci_get_data(pStmt->request, i, CCI_A_TYPE_BIT, &bit, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+/*
+ * Record the row count of a new result set, at most -maxrows.
+ */
+static void CubridSetRowCount(CUBRIDStmt *pStmt, int count) {
+    pStmt->truncated = (pStmt->maxRows > 0 && count > pStmt->maxRows);
+    pStmt->rowCount = pStmt->truncated ? pStmt->maxRows : count;
+    pStmt->position = 0;
+}
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewStringObj(bit.buf, bit.size));
-                }
+/*
+ * Limit the rows the server produces for a statement to -maxrows, plus the
+ * one that tells whether the result was truncated.
+ */
+static int CubridApplyMaxRows(CUBRIDStmt *pStmt) {
+    return cci_set_max_row(pStmt->request,
+                           pStmt->maxRows > 0 ? pStmt->maxRows + 1 : 0);
+}
 
-                break;
+/*
+ * With -all the result info only describes the first query, so walk the
+ * query results of the request and drop the schema cache if any of them
+ * changed the schema. If they cannot be read, drop it anyway.
+ */
+static void CubridSchemaCheckResults(CUBRIDStmt *pStmt) {
+    T_CCI_QUERY_RESULT *qr = NULL;
+    T_CCI_ERROR cci_error;
+    int i, n;
 
-            case CCI_U_TYPE_CLOB:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_CLOB,
-                                     (void *)&clob, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+    n = cci_execute_result(pStmt->request, &qr, &cci_error);
+    if (n < 0) {
+        CubridSchemaInvalidate(pStmt->pDb);
+        return;
+    }
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    res = cci_clob_read(pDb->connection, clob, 0,
-                                        CUBRID_LOB_READ_BUF_SIZE, buffer,
-                                        &cci_error);
-                    if (res < 0) {
-                        Tcl_SetResult(interp, (char *)"read clob failed", NULL);
-                        return TCL_ERROR;
-                    }
+    for (i = 1; i <= n; i++) {
+        if (CubridIsSchemaChange(CCI_QUERY_RESULT_STMT_TYPE(qr, i))) {
+            CubridSchemaInvalidate(pStmt->pDb);
+            break;
+        }
+    }
 
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewStringObj(buffer, res));
-                    cci_clob_free(clob);
-                }
+    if (qr != NULL) {
+        cci_query_result_free(qr, n);
+    }
+}
+
+/*
+ * Move a statement to its next result (statements executed with -all).
+ * Returns 1 and the row count of the new result, 0 if there are no more
+ * results, or -1 with an error message in interp.
+ */
+static int CubridNextResult(Tcl_Interp *interp, CUBRIDStmt *pStmt,
+                            int *countPtr) {
+    T_CCI_ERROR cci_error;
+    int res;
+
+    cci_error.err_code = 0;
+    cci_error.err_msg[0] = '\0';
+
+    res = cci_next_result(pStmt->request, &cci_error);
+    if (res == CAS_ER_NO_MORE_RESULT_SET ||
+        (res < 0 && cci_error.err_code == CAS_ER_NO_MORE_RESULT_SET)) {
+        return 0;
+    }
+
+    if (res < 0) {
+        if (cci_error.err_msg[0] != '\0') {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        } else {
+            Tcl_SetResult(interp, (char *)"next result failed", NULL);
+        }
+        return -1;
+    }
+
+    CubridSetRowCount(pStmt, res);
+    *countPtr = pStmt->rowCount;
+    return 1;
+}
+
+/*
+ * Read the keys an INSERT executed with CCI_EXEC_RETURN_GENERATED_KEYS left
+ * on the request: one row per inserted row, one column per AUTO_INCREMENT
+ * column. A row with a single column is returned as that value.
+ */
+static int CubridGeneratedKeys(Tcl_Interp *interp, CUBRIDStmt *pStmt,
+                               Tcl_Obj **keysPtr) {
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    Tcl_Obj *keysObj;
+    Tcl_Obj *rowPtr;
+    Tcl_Obj *keyPtr;
+    int col_count = 0;
+    int error;
+
+    keysObj = Tcl_NewListObj(0, NULL);
+
+    col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+    if (col_info == NULL || col_count == 0) {
+        *keysPtr = keysObj;
+        return TCL_OK;
+    }
+
+    while (1) {
+        error = CubridCursor(pStmt, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            break;
+        }
+        if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            goto error;
+        }
+
+        if (CubridGetRow(interp, pStmt->pDb, pStmt->request, 0, &rowPtr) !=
+            TCL_OK) {
+            goto error;
+        }
+
+        if (col_count == 1) {
+            Tcl_ListObjIndex(NULL, rowPtr, 0, &keyPtr);
+            Tcl_ListObjAppendElement(NULL, keysObj, keyPtr);
+            Tcl_IncrRefCount(rowPtr);
+            Tcl_DecrRefCount(rowPtr);
+        } else {
+            Tcl_ListObjAppendElement(NULL, keysObj, rowPtr);
+        }
+    }
+
+    *keysPtr = keysObj;
+    return TCL_OK;
+
+error:
+    Tcl_IncrRefCount(keysObj);
+    Tcl_DecrRefCount(keysObj);
+    return TCL_ERROR;
+}
+
+/*
+ * STMT_HANDLE export channel ?-format csv|tsv? ?-header? ?-null string?
+ *     ?-batch rows?
+ *
+ * Write the remaining rows of the current result to channel, one line per
+ * row, and return the number of rows written. Rows are collected in a
+ * buffer and written every -batch rows.
+ */
+static int CubridExportCmd(Tcl_Interp *interp, CUBRIDStmt *pStmt, int objc,
+                           Tcl_Obj *const *objv) {
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    Tcl_Channel chan;
+    Tcl_DString out, field;
+    const char *nullStr = "";
+    Tcl_Size nullLen = 0;
+    int mode;
+    int tsv = 0;
+    int header = 0;
+    int batch = 1000;
+    int col_count = 0;
+    int rows = 0;
+    int isNull;
+    int error;
+    int option;
+    int i;
+    int rc = TCL_OK;
+
+    static const char *EXPORT_strs[] = {"-format", "-header", "-null",
+                                        "-batch", 0};
+    enum EXPORT_enum { EXPORT_FORMAT, EXPORT_HEADER, EXPORT_NULL, EXPORT_BATCH };
+    static const char *FORMAT_strs[] = {"csv", "tsv", 0};
+
+    if (objc < 3) {
+        Tcl_WrongNumArgs(interp, 2, objv,
+                         "channel ?-format csv|tsv? ?-header? ?-null string? "
+                         "?-batch rows?");
+        return TCL_ERROR;
+    }
+
+    chan = Tcl_GetChannel(interp, Tcl_GetString(objv[2]), &mode);
+    if (chan == NULL) {
+        return TCL_ERROR;
+    }
+    if (!(mode & TCL_WRITABLE)) {
+        Tcl_AppendResult(interp, "channel \"", Tcl_GetString(objv[2]),
+                         "\" wasn't opened for writing", (char *)0);
+        return TCL_ERROR;
+    }
+
+    for (i = 3; i < objc; i++) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], EXPORT_strs, "option", 0,
+                                &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        if (option != EXPORT_HEADER && i + 1 >= objc) {
+            Tcl_AppendResult(interp, "missing value for ",
+                             Tcl_GetString(objv[i]), (char *)0);
+            return TCL_ERROR;
+        }
+
+        switch ((enum EXPORT_enum)option) {
+        case EXPORT_FORMAT:
+            if (Tcl_GetIndexFromObj(interp, objv[++i], FORMAT_strs, "format",
+                                    0, &tsv) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            break;
+        case EXPORT_HEADER:
+            header = 1;
+            break;
+        case EXPORT_NULL:
+            nullStr = Tcl_GetStringFromObj(objv[++i], &nullLen);
+            break;
+        case EXPORT_BATCH:
+            if (Tcl_GetIntFromObj(interp, objv[++i], &batch) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (batch < 1) {
+                Tcl_SetResult(interp, (char *)"-batch must be positive", NULL);
+                return TCL_ERROR;
+            }
+            break;
+        }
+    }
+
+    col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+    if (col_info == NULL || col_count == 0) {
+        Tcl_SetResult(interp, (char *)"statement has no result set", NULL);
+        return TCL_ERROR;
+    }
+
+    Tcl_DStringInit(&out);
+    Tcl_DStringInit(&field);
+
+    if (header) {
+        for (i = 1; i <= col_count; i++) {
+            const char *name = CCI_GET_RESULT_INFO_NAME(col_info, i);
+
+            if (i > 1) {
+                Tcl_DStringAppend(&out, tsv ? "\t" : ",", 1);
+            }
+            CubridAppendField(&out, name, (Tcl_Size)strlen(name), tsv);
+        }
+        Tcl_DStringAppend(&out, "\n", 1);
+    }
 
+    while (1) {
+        error = CubridCursor(pStmt, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            break;
+        }
+        if (error >= 0) {
+            error = cci_fetch(pStmt->request, &cci_error);
+        }
+        if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            rc = TCL_ERROR;
+            break;
+        }
+
+        for (i = 1; i <= col_count; i++) {
+            if (i > 1) {
+                Tcl_DStringAppend(&out, tsv ? "\t" : ",", 1);
+            }
+
+            if (CubridGetColumnText(interp, pStmt->pDb, pStmt->request, i,
+                                    CCI_GET_RESULT_INFO_TYPE(col_info, i),
+                                    &field, &isNull) != TCL_OK) {
+                rc = TCL_ERROR;
                 break;
+            }
 
-            case CCI_U_TYPE_BLOB:
-                error = cci_get_data(pStmt->request, i, CCI_A_TYPE_BLOB,
-                                     (void *)&blob, &ind);
-                if (error < 0) {
-                    Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                    return TCL_ERROR;
-                }
+            if (isNull) {
+                Tcl_DStringAppend(&out, nullStr, nullLen);
+            } else {
+                CubridAppendField(&out, Tcl_DStringValue(&field),
+                                  Tcl_DStringLength(&field), tsv);
+            }
+        }
+        if (rc != TCL_OK) {
+            break;
+        }
 
-                if (ind < 0) {
-                    /*
-                     * If a value is NULL, the returned dictionary for the
-                     * row will not contain the corresponding key.
-                     */
-                } else {
-                    res = cci_blob_read(pDb->connection, blob, 0,
-                                        CUBRID_LOB_READ_BUF_SIZE, buffer,
-                                        &cci_error);
-                    if (res < 0) {
-                        Tcl_SetResult(interp, (char *)"read blob failed", NULL);
-                        return TCL_ERROR;
-                    }
+        Tcl_DStringAppend(&out, "\n", 1);
+        rows++;
 
-                    Tcl_DictObjPut(interp, pResultStr,
-                                   Tcl_NewStringObj(name, -1),
-                                   Tcl_NewStringObj(buffer, res));
-                    cci_clob_free(blob);
-                }
+        if (rows % batch == 0) {
+            if (Tcl_WriteChars(chan, Tcl_DStringValue(&out),
+                               Tcl_DStringLength(&out)) < 0) {
+                goto writeError;
+            }
+            Tcl_DStringSetLength(&out, 0);
+        }
+    }
+
+    if (rc == TCL_OK && Tcl_DStringLength(&out) > 0 &&
+        Tcl_WriteChars(chan, Tcl_DStringValue(&out),
+                       Tcl_DStringLength(&out)) < 0) {
+        goto writeError;
+    }
+
+    Tcl_DStringFree(&out);
+    Tcl_DStringFree(&field);
+
+    if (rc == TCL_OK) {
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(rows));
+    }
+
+    return rc;
+
+writeError:
+    Tcl_AppendResult(interp, "error writing \"", Tcl_GetString(objv[2]),
+                     "\": ", Tcl_PosixError(interp), (char *)0);
+    Tcl_DStringFree(&out);
+    Tcl_DStringFree(&field);
+    return TCL_ERROR;
+}
+
+/*
+ * Append str as a JSON string. A NUL in Tcl's UTF-8 (C0 80) is \u0000.
+ */
+static void CubridAppendJsonString(Tcl_DString *dsPtr, const char *str,
+                                   Tcl_Size len) {
+    const char *p;
+    const char *run = str;
+    const char *end = str + len;
+    char escape[8];
+
+    Tcl_DStringAppend(dsPtr, "\"", 1);
+    for (p = str; p < end; p++) {
+        unsigned char c = (unsigned char)*p;
+
+        if (c >= 0x20 && c != '"' && c != '\\' &&
+            !(c == 0xC0 && p + 1 < end && (unsigned char)p[1] == 0x80)) {
+            continue;
+        }
+
+        Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(p - run));
+        switch (c) {
+        case '"':
+            Tcl_DStringAppend(dsPtr, "\\\"", 2);
+            break;
+        case '\\':
+            Tcl_DStringAppend(dsPtr, "\\\\", 2);
+            break;
+        case '\n':
+            Tcl_DStringAppend(dsPtr, "\\n", 2);
+            break;
+        case '\r':
+            Tcl_DStringAppend(dsPtr, "\\r", 2);
+            break;
+        case '\t':
+            Tcl_DStringAppend(dsPtr, "\\t", 2);
+            break;
+        case 0xC0:
+            Tcl_DStringAppend(dsPtr, "\\u0000", 6);
+            p++;
+            break;
+        default:
+            sprintf(escape, "\\u%04x", c);
+            Tcl_DStringAppend(dsPtr, escape, 6);
+            break;
+        }
+        run = p + 1;
+    }
+    Tcl_DStringAppend(dsPtr, run, (Tcl_Size)(end - run));
+    Tcl_DStringAppend(dsPtr, "\"", 1);
+}
+
+/*
+ * Append bytes as a JSON string of hex digits, two a byte.
+ */
+static void CubridAppendJsonHex(Tcl_DString *dsPtr, const unsigned char *bytes,
+                                Tcl_Size len) {
+    static const char hexDigits[] = "0123456789abcdef";
+    Tcl_Size start = Tcl_DStringLength(dsPtr);
+    Tcl_Size i;
+    char *p;
+
+    Tcl_DStringSetLength(dsPtr, start + 2 * len + 2);
+    p = Tcl_DStringValue(dsPtr) + start;
+    *p++ = '"';
+    for (i = 0; i < len; i++) {
+        *p++ = hexDigits[bytes[i] >> 4];
+        *p++ = hexDigits[bytes[i] & 0xf];
+    }
+    *p = '"';
+}
+
+/*
+ * Is str a JSON number? NUMERIC values are passed through as they are
+ * when they are, to keep their precision.
+ */
+static int CubridIsJsonNumber(const char *str) {
+    const char *p = str;
+
+    if (*p == '-') {
+        p++;
+    }
+    if (*p == '0') {
+        p++;
+    } else if (*p >= '1' && *p <= '9') {
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    } else {
+        return 0;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p < '0' || *p > '9') {
+            return 0;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-') {
+            p++;
+        }
+        if (*p < '0' || *p > '9') {
+            return 0;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    return *p == '\0';
+}
+
+/*
+ * Append a double as a JSON number, or null if it is not finite.
+ */
+static void CubridAppendJsonDouble(Tcl_DString *dsPtr, double value) {
+    char tbuf[TCL_DOUBLE_SPACE];
+
+    if (value != value || value - value != 0.0) {
+        Tcl_DStringAppend(dsPtr, "null", 4);
+        return;
+    }
+
+    Tcl_PrintDouble(NULL, value, tbuf);
+    Tcl_DStringAppend(dsPtr, tbuf, -1);
+}
+
+/*
+ * Append column i of the fetched row as a JSON value: numbers unquoted,
+ * NULL as null, JSON columns as they are, collections as arrays, BLOB and
+ * BIT bytes as hex strings, and everything else as a string with the text
+ * fetch_row_dict returns.
+ */
+static int CubridAppendJsonColumn(Tcl_Interp *interp, CUBRIDDATA *pDb,
+                                  int request, int i, T_CCI_U_TYPE type,
+                                  Tcl_DString *dsPtr, Tcl_DString *fieldPtr) {
+    T_CCI_SET cci_set;
+    T_CCI_DATE date;
+    Tcl_Obj *elemPtr;
+    Tcl_Size len;
+    char tbuf[64];
+    char *res_buf;
+    unsigned char *bytes;
+    const char *str;
+    int set_size, elem_type;
+    int error, ind, isNull;
+    int count;
+
+    switch (type) {
+    case CCI_U_TYPE_INT:
+    case CCI_U_TYPE_SHORT:
+    case CCI_U_TYPE_BIGINT:
+    case CCI_U_TYPE_JSON:
+        error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+        if (error >= 0) {
+            if (ind < 0) {
+                Tcl_DStringAppend(dsPtr, "null", 4);
+            } else {
+                Tcl_DStringAppend(dsPtr, res_buf, -1);
+            }
+        }
+        break;
+
+    case CCI_U_TYPE_FLOAT:
+    case CCI_U_TYPE_DOUBLE:
+    case CCI_U_TYPE_NUMERIC:
+    case CCI_U_TYPE_MONETARY:
+        error = cci_get_data(request, i, CCI_A_TYPE_STR, &res_buf, &ind);
+        if (error >= 0) {
+            if (ind < 0) {
+                Tcl_DStringAppend(dsPtr, "null", 4);
+            } else if (type == CCI_U_TYPE_NUMERIC &&
+                       CubridIsJsonNumber(res_buf)) {
+                Tcl_DStringAppend(dsPtr, res_buf, -1);
+            } else {
+                CubridAppendJsonDouble(dsPtr, atof(res_buf));
+            }
+        }
+        break;
+
+    case CCI_U_TYPE_DATE:
+    case CCI_U_TYPE_TIME:
+    case CCI_U_TYPE_TIMESTAMP:
+        error = cci_get_data(request, i, CCI_A_TYPE_DATE, &date, &ind);
+        if (error >= 0) {
+            if (ind < 0) {
+                Tcl_DStringAppend(dsPtr, "null", 4);
+            } else {
+                CubridFormatDate(type, &date, 1, tbuf);
+                CubridAppendJsonString(dsPtr, tbuf, (Tcl_Size)strlen(tbuf));
+            }
+        }
+        break;
+
+    case CCI_U_TYPE_BIT:
+    case CCI_U_TYPE_VARBIT:
+    case CCI_U_TYPE_BLOB:
+        if (type == CCI_U_TYPE_BLOB || pDb->bitFormat == CUBRID_BITS_BYTES) {
+            if (CubridGetColumn(interp, pDb, request, i, type, 0,
+                                &elemPtr) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (elemPtr == NULL) {
+                Tcl_DStringAppend(dsPtr, "null", 4);
+            } else {
+                Tcl_IncrRefCount(elemPtr);
+                bytes = Tcl_GetByteArrayFromObj(elemPtr, &len);
+                CubridAppendJsonHex(dsPtr, bytes, len);
+                Tcl_DecrRefCount(elemPtr);
+            }
+            return TCL_OK;
+        }
+        /* FALLTHRU */
+
+    default:
+        if (!CCI_IS_COLLECTION_TYPE(type)) {
+            if (CubridGetColumnText(interp, pDb, request, i, type, fieldPtr,
+                                    &isNull) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (isNull) {
+                Tcl_DStringAppend(dsPtr, "null", 4);
+            } else {
+                CubridAppendJsonString(dsPtr, Tcl_DStringValue(fieldPtr),
+                                       Tcl_DStringLength(fieldPtr));
+            }
+            return TCL_OK;
+        }
+
+        error = cci_get_data(request, i, CCI_A_TYPE_SET, (void *)&cci_set,
+                             &ind);
+        if (error < 0) {
+            break;
+        }
+        if (ind < 0) {
+            Tcl_DStringAppend(dsPtr, "null", 4);
+            break;
+        }
+
+        set_size = cci_set_size(cci_set);
+        elem_type = cci_set_element_type(cci_set);
+        Tcl_DStringAppend(dsPtr, "[", 1);
+        for (count = 0; count < set_size; count++) {
+            if (count > 0) {
+                Tcl_DStringAppend(dsPtr, ",", 1);
+            }
 
+            if (CubridGetSetElement(cci_set, count + 1, elem_type, 1,
+                                    &elemPtr) < 0) {
+                cci_set_free(cci_set);
+                Tcl_SetResult(interp, (char *)"Get set data fail.", NULL);
+                return TCL_ERROR;
+            }
+
+            Tcl_IncrRefCount(elemPtr);
+            str = Tcl_GetStringFromObj(elemPtr, &len);
+            switch (elem_type) {
+            case CCI_U_TYPE_INT:
+            case CCI_U_TYPE_SHORT:
+            case CCI_U_TYPE_BIGINT:
+                if (len == 0) {
+                    Tcl_DStringAppend(dsPtr, "null", 4);
+                } else {
+                    Tcl_DStringAppend(dsPtr, str, len);
+                }
                 break;
+            case CCI_U_TYPE_FLOAT:
+            case CCI_U_TYPE_DOUBLE: {
+                double double_val;
 
+                if (len == 0 ||
+                    Tcl_GetDoubleFromObj(NULL, elemPtr, &double_val) !=
+                        TCL_OK) {
+                    Tcl_DStringAppend(dsPtr, "null", 4);
+                } else {
+                    CubridAppendJsonDouble(dsPtr, double_val);
+                }
+                break;
+            }
             default:
-                if (CCI_IS_COLLECTION_TYPE(type)) {
-                    error = cci_get_data(pStmt->request, i, CCI_A_TYPE_SET,
-                                         (void *)&cci_set, &ind);
-                    if (error < 0) {
-                        Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                        return TCL_ERROR;
-                    }
+                CubridAppendJsonString(dsPtr, str, len);
+                break;
+            }
+            Tcl_DecrRefCount(elemPtr);
+        }
+        Tcl_DStringAppend(dsPtr, "]", 1);
+        cci_set_free(cci_set);
+        break;
+    }
 
-                    if (ind < 0) {
-                        /*
-                         * If a value is NULL, the returned dictionary for the
-                         * row will not contain the corresponding key.
-                         */
-                    } else {
-                        set_size = cci_set_size(cci_set);
-                        if (set_size <= 0) {
-                            Tcl_SetResult(interp, (char *)"Set size is wrong.",
-                                          NULL);
-                            return TCL_ERROR;
-                        }
-
-                        pResultSet = Tcl_NewListObj(0, NULL);
-                        for (count = 0; count < set_size; count++) {
-                            res =
-                                cci_set_get(cci_set, count + 1, CCI_A_TYPE_STR,
-                                            &set_buffer, &ind);
-                            if (res < 0) {
-                                Tcl_SetResult(
-                                    interp, (char *)"Get set data fail.", NULL);
-                                return TCL_ERROR;
-                            }
-
-                            Tcl_ListObjAppendElement(
-                                interp, pResultSet,
-                                Tcl_NewStringObj(set_buffer, -1));
-                        }
-
-                        Tcl_DictObjPut(interp, pResultStr,
-                                       Tcl_NewStringObj(name, -1), pResultSet);
+    if (error < 0) {
+        Tcl_SetResult(interp, (char *)"get data failed", NULL);
+        return TCL_ERROR;
+    }
 
-                        cci_set_free(cci_set);
-                    }
-                } else {
-                    error = cci_get_data(pStmt->request, i, CCI_A_TYPE_STR,
-                                         &res_buf, &ind);
-                    if (error < 0) {
-                        Tcl_SetResult(interp, (char *)"get data failed", NULL);
-                        return TCL_ERROR;
-                    }
+    return TCL_OK;
+}
+
+/*
+ * STMT_HANDLE fetch_json ?-max rows? ?-array|-objects? ?-channel channel?
+ *
+ * Encode the rows after the cursor as a JSON array of objects (the
+ * default) or of arrays. The text is returned, or written to -channel in
+ * pieces and the number of rows returned.
+ */
+static int CubridFetchJsonCmd(Tcl_Interp *interp, CUBRIDStmt *pStmt,
+                              int objc, Tcl_Obj *const *objv) {
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    Tcl_Channel chan = NULL;
+    Tcl_DString out, field;
+    Tcl_Obj *chanName = NULL;
+    const char *name;
+    int mode;
+    int asArray = 0;
+    int maxRows = -1;
+    int col_count = 0;
+    int rows = 0;
+    int error;
+    int option;
+    int i;
+    int rc = TCL_OK;
+
+    static const char *JSON_strs[] = {"-max", "-array", "-objects",
+                                      "-channel", 0};
+    enum JSON_enum { JSON_MAX, JSON_ARRAY, JSON_OBJECTS, JSON_CHANNEL };
+
+    for (i = 2; i < objc; i++) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], JSON_strs, "option", 0,
+                                &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        switch ((enum JSON_enum)option) {
+        case JSON_MAX:
+            if (i + 1 >= objc) {
+                Tcl_SetResult(interp, (char *)"missing value for -max", NULL);
+                return TCL_ERROR;
+            }
+            if (Tcl_GetIntFromObj(interp, objv[++i], &maxRows) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            break;
+        case JSON_ARRAY:
+            asArray = 1;
+            break;
+        case JSON_OBJECTS:
+            asArray = 0;
+            break;
+        case JSON_CHANNEL:
+            if (i + 1 >= objc) {
+                Tcl_SetResult(interp, (char *)"missing value for -channel",
+                              NULL);
+                return TCL_ERROR;
+            }
+            chanName = objv[++i];
+            chan = Tcl_GetChannel(interp, Tcl_GetString(chanName), &mode);
+            if (chan == NULL) {
+                return TCL_ERROR;
+            }
+            if (!(mode & TCL_WRITABLE)) {
+                Tcl_AppendResult(interp, "channel \"",
+                                 Tcl_GetString(chanName),
+                                 "\" wasn't opened for writing", (char *)0);
+                return TCL_ERROR;
+            }
+            break;
+        }
+    }
+
+    col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+    if (col_info == NULL || col_count == 0) {
+        Tcl_SetResult(interp, (char *)"statement has no result set", NULL);
+        return TCL_ERROR;
+    }
+
+    Tcl_DStringInit(&out);
+    Tcl_DStringInit(&field);
+    Tcl_DStringAppend(&out, "[", 1);
+
+    while (maxRows < 0 || rows < maxRows) {
+        error = CubridCursor(pStmt, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            break;
+        }
+        if (error >= 0) {
+            error = cci_fetch(pStmt->request, &cci_error);
+        }
+        if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            rc = TCL_ERROR;
+            break;
+        }
+
+        if (rows > 0) {
+            Tcl_DStringAppend(&out, ",", 1);
+        }
+        Tcl_DStringAppend(&out, asArray ? "[" : "{", 1);
+
+        for (i = 1; i <= col_count; i++) {
+            if (i > 1) {
+                Tcl_DStringAppend(&out, ",", 1);
+            }
+            if (!asArray) {
+                name = CCI_GET_RESULT_INFO_NAME(col_info, i);
+                CubridAppendJsonString(&out, name, (Tcl_Size)strlen(name));
+                Tcl_DStringAppend(&out, ":", 1);
+            }
+
+            if (CubridAppendJsonColumn(interp, pStmt->pDb, pStmt->request, i,
+                                       CCI_GET_RESULT_INFO_TYPE(col_info, i),
+                                       &out, &field) != TCL_OK) {
+                rc = TCL_ERROR;
+                break;
+            }
+        }
+        if (rc != TCL_OK) {
+            break;
+        }
+
+        Tcl_DStringAppend(&out, asArray ? "]" : "}", 1);
+        rows++;
+
+        /*
+         * Write to the channel in pieces of about 64 KiB.
+         */
+        if (chan && Tcl_DStringLength(&out) >= 65536) {
+            if (Tcl_WriteChars(chan, Tcl_DStringValue(&out),
+                               Tcl_DStringLength(&out)) < 0) {
+                goto writeError;
+            }
+            Tcl_DStringSetLength(&out, 0);
+        }
+    }
+
+    if (rc == TCL_OK) {
+        Tcl_DStringAppend(&out, "]", 1);
+
+        if (chan) {
+            if (Tcl_WriteChars(chan, Tcl_DStringValue(&out),
+                               Tcl_DStringLength(&out)) < 0) {
+                goto writeError;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(rows));
+        } else {
+            Tcl_SetObjResult(interp,
+                             Tcl_NewStringObj(Tcl_DStringValue(&out),
+                                              Tcl_DStringLength(&out)));
+        }
+    }
+
+    Tcl_DStringFree(&out);
+    Tcl_DStringFree(&field);
+    return rc;
+
+writeError:
+    Tcl_AppendResult(interp, "error writing \"", Tcl_GetString(chanName),
+                     "\": ", Tcl_PosixError(interp), (char *)0);
+    Tcl_DStringFree(&out);
+    Tcl_DStringFree(&field);
+    return TCL_ERROR;
+}
+
+/*
+ * Reading state of one CSV or TSV record for STMT_HANDLE import. The
+ * decoded text of each field is appended to text, NUL terminated.
+ */
+typedef struct CubridRecord {
+    Tcl_DString *text;
+    Tcl_Size start;    /* offset of the field being read */
+    int quotedField;   /* the field being read started with a quote */
+    int fields;        /* fields ended so far */
+    int maxFields;     /* size of offsets and quoted */
+    Tcl_Size *offsets;
+    int *quoted;
+} CubridRecord;
+
+static void CubridEndField(CubridRecord *recPtr) {
+    if (recPtr->fields < recPtr->maxFields) {
+        recPtr->offsets[recPtr->fields] = recPtr->start;
+        recPtr->quoted[recPtr->fields] = recPtr->quotedField;
+    }
+    recPtr->fields++;
+
+    Tcl_DStringAppend(recPtr->text, "", 1);
+    recPtr->start = Tcl_DStringLength(recPtr->text);
+    recPtr->quotedField = 0;
+}
+
+/*
+ * Read the next record from chan. Blank lines are skipped, and a quoted
+ * CSV field may hold line breaks. Returns the number of fields, 0 at the
+ * end of the channel or -1 on a read error.
+ */
+static int CubridReadRecord(Tcl_Channel chan, Tcl_Obj *linePtr, int tsv,
+                            CubridRecord *recPtr) {
+    Tcl_DString *text = recPtr->text;
+    const char *line, *p, *run, *end;
+    Tcl_Size len;
+    int inQuotes = 0;
+    char c;
+
+    recPtr->start = Tcl_DStringLength(text);
+    recPtr->quotedField = 0;
+    recPtr->fields = 0;
+
+    while (1) {
+        Tcl_SetObjLength(linePtr, 0);
+        if (Tcl_GetsObj(chan, linePtr) < 0) {
+            if (!Tcl_Eof(chan)) {
+                return -1;
+            }
+            if (!inQuotes) {
+                return 0;
+            }
+
+            /*
+             * A quote left open at the end of the channel ends the record.
+             */
+            break;
+        }
+
+        line = Tcl_GetStringFromObj(linePtr, &len);
+        if (len == 0 && !inQuotes) {
+            continue;
+        }
+
+        if (inQuotes) {
+            Tcl_DStringAppend(text, "\n", 1);
+        }
+
+        run = line;
+        end = line + len;
+        for (p = line; p < end; p++) {
+            if (tsv) {
+                if (*p == '\t') {
+                    Tcl_DStringAppend(text, run, (Tcl_Size)(p - run));
+                    CubridEndField(recPtr);
+                    run = p + 1;
+                } else if (*p == '\\' && p + 1 < end) {
+                    Tcl_DStringAppend(text, run, (Tcl_Size)(p - run));
+                    p++;
+                    c = (*p == 't') ? '\t'
+                        : (*p == 'n') ? '\n'
+                        : (*p == 'r') ? '\r'
+                                      : *p;
+                    Tcl_DStringAppend(text, &c, 1);
+                    run = p + 1;
+                }
+            } else if (inQuotes) {
+                if (*p == '"') {
+                    Tcl_DStringAppend(text, run, (Tcl_Size)(p - run));
+                    if (p + 1 < end && p[1] == '"') {
+                        Tcl_DStringAppend(text, "\"", 1);
+                        p++;
+                    } else {
+                        inQuotes = 0;
+                    }
+                    run = p + 1;
+                }
+            } else if (*p == '"' && p == run &&
+                       Tcl_DStringLength(text) == recPtr->start &&
+                       !recPtr->quotedField) {
+                inQuotes = 1;
+                recPtr->quotedField = 1;
+                run = p + 1;
+            } else if (*p == ',') {
+                Tcl_DStringAppend(text, run, (Tcl_Size)(p - run));
+                CubridEndField(recPtr);
+                run = p + 1;
+            }
+        }
+        Tcl_DStringAppend(text, run, (Tcl_Size)(end - run));
+
+        if (!inQuotes) {
+            break;
+        }
+    }
+
+    CubridEndField(recPtr);
+    return recPtr->fields;
+}
+
+/*
+ * The values of one ? marker for a batch of STMT_HANDLE import rows, in
+ * the C type given to cci_bind_param_array.
+ */
+typedef struct CubridImportColumn {
+    T_CCI_U_TYPE utype;
+    T_CCI_A_TYPE atype;
+    size_t elemSize;
+    char *values;
+    int *nulls;
+    Tcl_Size *offsets; /* string values, in the record text */
+} CubridImportColumn;
+
+/*
+ * Send a batch of rows with cci_execute_array and count the rows the
+ * server took and rejected.
+ */
+static int CubridImportFlush(Tcl_Interp *interp, CUBRIDStmt *pStmt,
+                             CubridImportColumn *cols, int ncols, int rows,
+                             Tcl_DString *text, int *loadedPtr,
+                             int *rejectedPtr) {
+    T_CCI_QUERY_RESULT *qr = NULL;
+    T_CCI_ERROR cci_error;
+    int res;
+    int c, r;
+
+    if (rows == 0) {
+        return TCL_OK;
+    }
+
+    if (cci_bind_param_array_size(pStmt->request, rows) < 0) {
+        Tcl_SetResult(interp, (char *)"bind data failed", NULL);
+        return TCL_ERROR;
+    }
+
+    for (c = 0; c < ncols; c++) {
+        if (cols[c].atype == CCI_A_TYPE_STR) {
+            for (r = 0; r < rows; r++) {
+                ((char **)cols[c].values)[r] =
+                    Tcl_DStringValue(text) + cols[c].offsets[r];
+            }
+        }
+
+        if (cci_bind_param_array(pStmt->request, c + 1, cols[c].atype,
+                                 cols[c].values, cols[c].nulls,
+                                 cols[c].utype) < 0) {
+            Tcl_SetResult(interp, (char *)"bind data failed", NULL);
+            return TCL_ERROR;
+        }
+    }
+
+    res = cci_execute_array(pStmt->request, &qr, &cci_error);
+    pStmt->rowCount = -1;
+    pStmt->position = 0;
+    pStmt->truncated = 0;
+    if (res < 0) {
+        Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        return TCL_ERROR;
+    }
+
+    for (r = 1; r <= res; r++) {
+        if (CCI_QUERY_RESULT_RESULT(qr, r) < 0) {
+            (*rejectedPtr)++;
+        } else {
+            (*loadedPtr)++;
+        }
+    }
+    cci_query_result_free(qr, res);
+
+    return TCL_OK;
+}
+
+/*
+ * Take the statement out of array execution after an import: the markers
+ * are bound to NULL, so no bind points at the batch buffers, and the next
+ * execute sends one row again.
+ */
+static void CubridImportReset(CUBRIDStmt *pStmt, int ncols) {
+    int c;
+
+    cci_bind_param_array_size(pStmt->request, 0);
+    for (c = 0; c < ncols; c++) {
+        cci_bind_param(pStmt->request, c + 1, CCI_A_TYPE_STR, NULL,
+                       CCI_U_TYPE_NULL, 0);
+    }
+}
+
+/*
+ * STMT_HANDLE import channel ?-format csv|tsv? ?-types typeList? ?-header?
+ *     ?-null string? ?-batch rows? ?-commit-every rows?
+ *
+ * Execute the statement once per record of channel, with the fields bound
+ * to the ? markers in order, sending -batch rows at a time with
+ * cci_execute_array. Returns a dict with the rows loaded and rejected.
+ */
+static int CubridImportCmd(Tcl_Interp *interp, CUBRIDStmt *pStmt, int objc,
+                           Tcl_Obj *const *objv) {
+    CubridImportColumn *cols = NULL;
+    CubridRecord rec;
+    Tcl_Channel chan;
+    Tcl_DString text;
+    Tcl_Obj *linePtr = NULL;
+    Tcl_Obj *typesPtr = NULL;
+    Tcl_Obj **typeObjs;
+    Tcl_Obj *resultObj;
+    T_CCI_ERROR cci_error;
+    const char *nullStr = "";
+    const char *field;
+    char *endPtr;
+    Tcl_Size ntypes;
+    Tcl_Size rowStart;
+    int *typeIndexes = NULL;
+    int mode;
+    int tsv = 0;
+    int header = 0;
+    int batch = 1000;
+    int commitEvery = 0;
+    int sinceCommit = 0;
+    int ncols;
+    int rows = 0;
+    int loaded = 0;
+    int rejected = 0;
+    int fields;
+    int option;
+    int ok;
+    int c, i;
+    int rc = TCL_OK;
+    long lval;
+    Tcl_WideInt wval;
+
+    static const char *IMPORT_strs[] = {"-format", "-types", "-header",
+                                        "-null", "-batch", "-commit-every",
+                                        0};
+    enum IMPORT_enum {
+        IMPORT_FORMAT,
+        IMPORT_TYPES,
+        IMPORT_HEADER,
+        IMPORT_NULL,
+        IMPORT_BATCH,
+        IMPORT_COMMIT_EVERY
+    };
+    static const char *FORMAT_strs[] = {"csv", "tsv", 0};
+
+    if (objc < 3) {
+        Tcl_WrongNumArgs(interp, 2, objv,
+                         "channel ?-format csv|tsv? ?-types typeList? "
+                         "?-header? ?-null string? ?-batch rows? "
+                         "?-commit-every rows?");
+        return TCL_ERROR;
+    }
+
+    chan = Tcl_GetChannel(interp, Tcl_GetString(objv[2]), &mode);
+    if (chan == NULL) {
+        return TCL_ERROR;
+    }
+    if (!(mode & TCL_READABLE)) {
+        Tcl_AppendResult(interp, "channel \"", Tcl_GetString(objv[2]),
+                         "\" wasn't opened for reading", (char *)0);
+        return TCL_ERROR;
+    }
+
+    for (i = 3; i < objc; i++) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], IMPORT_strs, "option", 0,
+                                &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        if (option != IMPORT_HEADER && i + 1 >= objc) {
+            Tcl_AppendResult(interp, "missing value for ",
+                             Tcl_GetString(objv[i]), (char *)0);
+            return TCL_ERROR;
+        }
+
+        switch ((enum IMPORT_enum)option) {
+        case IMPORT_FORMAT:
+            if (Tcl_GetIndexFromObj(interp, objv[++i], FORMAT_strs, "format",
+                                    0, &tsv) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            break;
+        case IMPORT_TYPES:
+            typesPtr = objv[++i];
+            break;
+        case IMPORT_HEADER:
+            header = 1;
+            break;
+        case IMPORT_NULL:
+            nullStr = Tcl_GetString(objv[++i]);
+            break;
+        case IMPORT_BATCH:
+            if (Tcl_GetIntFromObj(interp, objv[++i], &batch) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (batch < 1) {
+                Tcl_SetResult(interp, (char *)"-batch must be positive", NULL);
+                return TCL_ERROR;
+            }
+            break;
+        case IMPORT_COMMIT_EVERY:
+            if (Tcl_GetIntFromObj(interp, objv[++i], &commitEvery) !=
+                TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (commitEvery < 0) {
+                Tcl_SetResult(interp,
+                              (char *)"-commit-every must not be negative",
+                              NULL);
+                return TCL_ERROR;
+            }
+            break;
+        }
+    }
+
+    if (commitEvery > 0 && pStmt->pDb->txDepth > 0) {
+        Tcl_SetResult(interp,
+                      (char *)"-commit-every cannot be used inside a "
+                              "transaction",
+                      NULL);
+        return TCL_ERROR;
+    }
+
+    /*
+     * The column types: -types, or the types the server reports.
+     */
+    CubridLoadParamTypes(pStmt);
+    ncols = pStmt->paramCount;
+    if (ncols < 1) {
+        Tcl_SetResult(interp, (char *)"statement has no parameters", NULL);
+        return TCL_ERROR;
+    }
+
+    typeIndexes = (int *)ckalloc(sizeof(int) * ncols);
+    if (typesPtr) {
+        if (Tcl_ListObjGetElements(interp, typesPtr, &ntypes, &typeObjs) !=
+            TCL_OK) {
+            ckfree((char *)typeIndexes);
+            return TCL_ERROR;
+        }
+        if (ntypes != ncols) {
+            Tcl_SetObjResult(interp,
+                             Tcl_ObjPrintf("-types has %d types, the "
+                                           "statement has %d parameters",
+                                           (int)ntypes, ncols));
+            ckfree((char *)typeIndexes);
+            return TCL_ERROR;
+        }
+        for (c = 0; c < ncols; c++) {
+            if (CubridGetTypeFromObj(interp, typeObjs[c], &typeIndexes[c]) !=
+                TCL_OK) {
+                ckfree((char *)typeIndexes);
+                return TCL_ERROR;
+            }
+        }
+    } else {
+        memcpy(typeIndexes, pStmt->paramTypes, sizeof(int) * ncols);
+    }
+
+    cols = (CubridImportColumn *)ckalloc(sizeof(CubridImportColumn) * ncols);
+    memset(cols, 0, sizeof(CubridImportColumn) * ncols);
+    for (c = 0; c < ncols; c++) {
+        T_CCI_U_TYPE utype =
+            cubridTypes[CUBRID_TYPE_BASE(typeIndexes[c])].utype;
+
+        if (CUBRID_TYPE_ELEM(typeIndexes[c]) >= 0) {
+            Tcl_SetResult(interp,
+                          (char *)"typed collections cannot be imported",
+                          NULL);
+            rc = TCL_ERROR;
+            goto done;
+        }
+
+        switch (utype) {
+        case CCI_U_TYPE_INT:
+        case CCI_U_TYPE_SHORT:
+            cols[c].atype = CCI_A_TYPE_INT;
+            cols[c].elemSize = sizeof(int);
+            break;
+        case CCI_U_TYPE_BIGINT:
+            cols[c].atype = CCI_A_TYPE_BIGINT;
+            cols[c].elemSize = sizeof(int64_t);
+            break;
+        case CCI_U_TYPE_FLOAT:
+        case CCI_U_TYPE_DOUBLE:
+        case CCI_U_TYPE_MONETARY:
+            cols[c].atype = CCI_A_TYPE_DOUBLE;
+            cols[c].elemSize = sizeof(double);
+            break;
+        case CCI_U_TYPE_BIT:
+        case CCI_U_TYPE_VARBIT:
+        case CCI_U_TYPE_CLOB:
+        case CCI_U_TYPE_BLOB:
+        case CCI_U_TYPE_SET:
+        case CCI_U_TYPE_MULTISET:
+        case CCI_U_TYPE_SEQUENCE:
+        case CCI_U_TYPE_NULL:
+            Tcl_SetObjResult(interp,
+                             Tcl_ObjPrintf("type %s cannot be imported",
+                                           cubridTypes[typeIndexes[c]].name));
+            rc = TCL_ERROR;
+            goto done;
+        default:
+            if (utype == CCI_U_TYPE_ENUM) {
+                utype = CCI_U_TYPE_STRING;
+            }
+            cols[c].atype = CCI_A_TYPE_STR;
+            cols[c].elemSize = sizeof(char *);
+            cols[c].offsets =
+                (Tcl_Size *)ckalloc(sizeof(Tcl_Size) * batch);
+            break;
+        }
+
+        cols[c].utype = utype;
+        cols[c].values = ckalloc(cols[c].elemSize * batch);
+        cols[c].nulls = (int *)ckalloc(sizeof(int) * batch);
+    }
+
+    Tcl_DStringInit(&text);
+    linePtr = Tcl_NewObj();
+    Tcl_IncrRefCount(linePtr);
+
+    rec.text = &text;
+    rec.maxFields = ncols;
+    rec.offsets = (Tcl_Size *)ckalloc(sizeof(Tcl_Size) * ncols);
+    rec.quoted = (int *)ckalloc(sizeof(int) * ncols);
+
+    while (1) {
+        rowStart = Tcl_DStringLength(&text);
+        fields = CubridReadRecord(chan, linePtr, tsv, &rec);
+        if (fields < 0) {
+            Tcl_AppendResult(interp, "error reading \"",
+                             Tcl_GetString(objv[2]),
+                             "\": ", Tcl_PosixError(interp), (char *)0);
+            rc = TCL_ERROR;
+            break;
+        }
+        if (fields == 0) {
+            break;
+        }
+
+        if (header) {
+            header = 0;
+            Tcl_DStringSetLength(&text, rowStart);
+            continue;
+        }
+
+        ok = (fields == ncols);
+        for (c = 0; ok && c < ncols; c++) {
+            field = Tcl_DStringValue(&text) + rec.offsets[c];
+
+            if (!rec.quoted[c] && strcmp(field, nullStr) == 0) {
+                cols[c].nulls[rows] = 1;
+                memset(cols[c].values + cols[c].elemSize * rows, 0,
+                       cols[c].elemSize);
+                if (cols[c].offsets) {
+                    cols[c].offsets[rows] = rec.offsets[c];
+                }
+                continue;
+            }
+
+            cols[c].nulls[rows] = 0;
+            errno = 0;
+            switch (cols[c].atype) {
+            case CCI_A_TYPE_INT:
+                lval = strtol(field, &endPtr, 10);
+                ok = (*field != '\0' && *endPtr == '\0' && errno == 0 &&
+                      lval >= INT_MIN && lval <= INT_MAX);
+                ((int *)cols[c].values)[rows] = (int)lval;
+                break;
+            case CCI_A_TYPE_BIGINT:
+                wval = (Tcl_WideInt)strtoll(field, &endPtr, 10);
+                ok = (*field != '\0' && *endPtr == '\0' && errno == 0);
+                ((int64_t *)cols[c].values)[rows] = (int64_t)wval;
+                break;
+            case CCI_A_TYPE_DOUBLE:
+                ((double *)cols[c].values)[rows] = strtod(field, &endPtr);
+                ok = (*field != '\0' && *endPtr == '\0' && errno == 0);
+                break;
+            default:
+                cols[c].offsets[rows] = rec.offsets[c];
+                break;
+            }
+        }
+
+        if (!ok) {
+            rejected++;
+            Tcl_DStringSetLength(&text, rowStart);
+            continue;
+        }
+
+        rows++;
+        if (rows == batch ||
+            (commitEvery > 0 && sinceCommit + rows >= commitEvery)) {
+            if (CubridImportFlush(interp, pStmt, cols, ncols, rows, &text,
+                                  &loaded, &rejected) != TCL_OK) {
+                rc = TCL_ERROR;
+                break;
+            }
+
+            sinceCommit += rows;
+            rows = 0;
+            Tcl_DStringSetLength(&text, 0);
+
+            if (commitEvery > 0 && sinceCommit >= commitEvery) {
+                if (cci_end_tran(pStmt->pDb->connection, CCI_TRAN_COMMIT,
+                                 &cci_error) < 0) {
+                    Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+                    rc = TCL_ERROR;
+                    break;
+                }
+                sinceCommit = 0;
+            }
+        }
+    }
+
+    if (rc == TCL_OK) {
+        rc = CubridImportFlush(interp, pStmt, cols, ncols, rows, &text,
+                               &loaded, &rejected);
+        sinceCommit += rows;
+    }
+
+    if (rc == TCL_OK && commitEvery > 0 && sinceCommit > 0 &&
+        cci_end_tran(pStmt->pDb->connection, CCI_TRAN_COMMIT,
+                     &cci_error) < 0) {
+        Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        rc = TCL_ERROR;
+    }
+
+    CubridImportReset(pStmt, ncols);
+
+    ckfree((char *)rec.offsets);
+    ckfree((char *)rec.quoted);
+    Tcl_DecrRefCount(linePtr);
+    Tcl_DStringFree(&text);
+
+    if (rc == TCL_OK) {
+        resultObj = Tcl_NewDictObj();
+        Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("loaded", -1),
+                       Tcl_NewIntObj(loaded));
+        Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("rejected", -1),
+                       Tcl_NewIntObj(rejected));
+        Tcl_SetObjResult(interp, resultObj);
+    }
+
+done:
+    for (c = 0; c < ncols; c++) {
+        if (cols[c].values) {
+            ckfree(cols[c].values);
+            ckfree((char *)cols[c].nulls);
+        }
+        if (cols[c].offsets) {
+            ckfree((char *)cols[c].offsets);
+        }
+    }
+    ckfree((char *)cols);
+    ckfree((char *)typeIndexes);
+
+    return rc;
+}
+
+/*
+ * Handle STMT_HANDLE command delete (close, rename to {} or the connection
+ * going away): close the request and free the statement. A statement of a
+ * detached connection only loses its command and hash entry.
+ */
+static void StmtDeleteCmd(void *stmt) {
+    CUBRIDStmt *pStmt = (CUBRIDStmt *)stmt;
+
+    if (pStmt->entry) {
+        Tcl_DeleteHashEntry(pStmt->entry);
+        pStmt->entry = NULL;
+    }
+    pStmt->cmd = NULL;
+
+    if (pStmt->pDb->detached) {
+        return;
+    }
+
+    if (pStmt->request > 0) {
+        cci_close_req_handle(pStmt->request);
+        pStmt->request = 0;
+    }
+
+    /*
+     * Check our BLOB/CLOB link again
+     */
+    CubridFreeLobLinks(pStmt);
+
+    if (pStmt->paramTypes) {
+        ckfree((char *)pStmt->paramTypes);
+    }
+
+    if (pStmt->scratch) {
+        ckfree(pStmt->scratch);
+    }
+
+    if (pStmt->prev) {
+        pStmt->prev->next = pStmt->next;
+    } else {
+        pStmt->pDb->stmts = pStmt->next;
+    }
+    if (pStmt->next) {
+        pStmt->next->prev = pStmt->prev;
+    }
+
+    Tcl_Free((char *)pStmt);
+}
+
+/*
+ * STMT_HANDLE command function
+ */
+static int CUBRID_STMT(void *cd, Tcl_Interp *interp, int objc,
+                       Tcl_Obj *const *objv) {
+    CUBRIDStmt *pStmt = (CUBRIDStmt *)cd;
+    CUBRIDDATA *pDb = pStmt->pDb;
+    int choice;
+    int rc = TCL_OK;
+
+    static const char *STMT_strs[] = {
+        "bind",
+        "bind_vars",
+        "execute",
+        "nextresult",
+        "cursor",
+        "seek",
+        "position",
+        "rowcount",
+        "fetch_row_list",
+        "fetch_row_dict",
+        "columns",
+        "columntype",
+        "paramtypes",
+        "export",
+        "import",
+        "fetch_json",
+        "configure",
+        "truncated",
+        "close",
+        0
+    };
+
+    enum STMT_enum {
+        STMT_BIND,
+        STMT_BIND_VARS,
+        STMT_EXECUTE,
+        STMT_NEXTRESULT,
+        STMT_CURSOR,
+        STMT_SEEK,
+        STMT_POSITION,
+        STMT_ROWCOUNT,
+        STMT_FETCH_ROW_LIST,
+        STMT_FETCH_ROW_DICT,
+        STMT_COLUMNS,
+        STMT_COLUMNTYPE,
+        STMT_PARAMTYPES,
+        STMT_EXPORT,
+        STMT_IMPORT,
+        STMT_FETCH_JSON,
+        STMT_CONFIGURE,
+        STMT_TRUNCATED,
+        STMT_CLOSE
+    };
+
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "SUBCOMMAND ...");
+        return TCL_ERROR;
+    }
+
+    if (Tcl_GetIndexFromObj(interp, objv[1], STMT_strs, "option", 0, &choice)) {
+        return TCL_ERROR;
+    }
+
+    if (pStmt->request < 0) {
+        return TCL_ERROR;
+    }
+
+    switch ((enum STMT_enum)choice) {
+    case STMT_BIND: {
+        int index;
+        int typeIndex;
+
+        if (objc == 5) {
+            if (Tcl_GetIntFromObj(interp, objv[2], &index) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            if (CubridGetTypeFromObj(interp, objv[3], &typeIndex) != TCL_OK) {
+                return TCL_ERROR;
+            }
+        } else {
+            Tcl_WrongNumArgs(interp, 2, objv, "index type value");
+            return TCL_ERROR;
+        }
+
+        if (CubridBindValue(interp, pStmt, index, typeIndex, objv[4], 0) !=
+            TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+        break;
+    }
+
+    case STMT_BIND_VARS: {
+        Tcl_Obj **namePtrs;
+        Tcl_Obj **specPtrs;
+        Tcl_Obj *valuePtr;
+        Tcl_Obj *dictPtr = NULL;
+        Tcl_Size nameCount, specCount;
+        int typeIndex;
+        int i;
+
+        if (objc == 3 || objc == 4) {
+            if (Tcl_ListObjGetElements(interp, objv[2], &nameCount,
+                                       &namePtrs) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            if (objc == 4) {
+                dictPtr = objv[3];
+            }
+        } else {
+            Tcl_WrongNumArgs(interp, 2, objv, "paramNameList ?dict?");
+            return TCL_ERROR;
+        }
+
+        CubridLoadParamTypes(pStmt);
+
+        /*
+         * Each element is "name ?type?", the n-th element is bound to the
+         * n-th ? marker. Without a type the type reported by the server is
+         * used. A name with no variable (or no dict key) binds NULL.
+         */
+        for (i = 0; i < nameCount; i++) {
+            if (Tcl_ListObjGetElements(interp, namePtrs[i], &specCount,
+                                       &specPtrs) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            if (specCount < 1 || specCount > 2) {
+                Tcl_SetObjResult(
+                    interp,
+                    Tcl_ObjPrintf("bad parameter \"%s\": should be name ?type?",
+                                  Tcl_GetString(namePtrs[i])));
+                return TCL_ERROR;
+            }
+
+            if (specCount == 2) {
+                if (CubridGetTypeFromObj(interp, specPtrs[1], &typeIndex) !=
+                    TCL_OK) {
+                    return TCL_ERROR;
+                }
+            } else if (i < pStmt->paramCount) {
+                typeIndex = pStmt->paramTypes[i];
+            } else {
+                typeIndex = CUBRID_TYPE_VARCHAR;
+            }
+
+            valuePtr = NULL;
+            if (dictPtr != NULL) {
+                if (Tcl_DictObjGet(interp, dictPtr, specPtrs[0], &valuePtr) !=
+                    TCL_OK) {
+                    return TCL_ERROR;
+                }
+            } else {
+                valuePtr = Tcl_ObjGetVar2(interp, specPtrs[0], NULL, 0);
+            }
+
+            if (CubridBindValue(interp, pStmt, i + 1, typeIndex, valuePtr,
+                                1) != TCL_OK) {
+                Tcl_SetObjResult(
+                    interp,
+                    Tcl_ObjPrintf("bind parameter \"%s\" (index %d, %s): %s",
+                                  Tcl_GetString(specPtrs[0]), i + 1,
+                                  cubridTypes[CUBRID_TYPE_BASE(typeIndex)].name,
+                                  Tcl_GetStringResult(interp)));
+                return TCL_ERROR;
+            }
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+        break;
+    }
+
+    case STMT_EXECUTE: {
+        Tcl_Obj *return_obj;
+        T_CCI_ERROR cci_error;
+        T_CCI_CUBRID_STMT stmt_type;
+        int col_count = 0;
+        int res;
+        int i, option;
+        char flag = 0;
+
+        int returnKeys = 0;
+        int returnCount = 0;
+
+        static const char *EXEC_strs[] = {
+            "-all",
+            "-count",
+            "-returnkeys",
+            0
+        };
+
+        enum EXEC_enum {
+            EXEC_ALL,
+            EXEC_COUNT,
+            EXEC_RETURNKEYS
+        };
+
+        for (i = 2; i < objc; i++) {
+            if (Tcl_GetIndexFromObj(interp, objv[i], EXEC_strs, "option", 0,
+                                    &option)) {
+                return TCL_ERROR;
+            }
+
+            switch ((enum EXEC_enum)option) {
+            case EXEC_ALL:
+                /*
+                 * Execute every query of a multi-statement SQL string,
+                 * STMT_HANDLE nextresult moves to the next one.
+                 */
+                flag |= CCI_EXEC_QUERY_ALL;
+                break;
+            case EXEC_COUNT:
+                /*
+                 * Return what cci_execute returns: the affected row count
+                 * of a DML statement, or the row count of a SELECT.
+                 */
+                returnCount = 1;
+                break;
+            case EXEC_RETURNKEYS:
+                /*
+                 * Return the AUTO_INCREMENT values of the inserted rows
+                 * instead of a boolean.
+                 */
+                flag |= CCI_EXEC_RETURN_GENERATED_KEYS;
+                returnKeys = 1;
+                break;
+            }
+        }
+
+        if (returnCount && returnKeys) {
+            Tcl_SetResult(interp,
+                          (char *)"-count and -returnkeys cannot be combined",
+                          NULL);
+            return TCL_ERROR;
+        }
+
+        res = cci_execute(pStmt->request, flag, 0, &cci_error);
+
+        /*
+         * After we execute prepared statement, try to free CLOB/BLOB memory.
+         */
+        CubridFreeLobLinks(pStmt);
+
+        pStmt->rowCount = -1;
+        pStmt->position = 0;
+        pStmt->truncated = 0;
+
+        if (res < 0) {
+            if (returnKeys || returnCount) {
+                Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+                return TCL_ERROR;
+            }
+            return_obj = Tcl_NewBooleanObj(0);
+        } else {
+            cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+            if (col_count > 0) {
+                CubridSetRowCount(pStmt, res);
+                res = pStmt->rowCount;
+            }
+            if (CubridIsSchemaChange(stmt_type)) {
+                CubridSchemaInvalidate(pStmt->pDb);
+            } else if (flag & CCI_EXEC_QUERY_ALL) {
+                CubridSchemaCheckResults(pStmt);
+            }
+
+            if (returnKeys) {
+                if (CubridGeneratedKeys(interp, pStmt, &return_obj) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+            } else if (returnCount) {
+                return_obj = Tcl_NewIntObj(res);
+            } else {
+                return_obj = Tcl_NewBooleanObj(1);
+            }
+        }
+
+        Tcl_SetObjResult(interp, return_obj);
+        break;
+    }
+
+    case STMT_NEXTRESULT: {
+        int count = 0;
+        int res;
+
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        res = CubridNextResult(interp, pStmt, &count);
+        if (res < 0) {
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(res));
+        break;
+    }
+
+    case STMT_CURSOR:
+    case STMT_SEEK: {
+        int offset = 0;
+        int index;
+        T_CCI_CURSOR_POS origin;
+        T_CCI_ERROR cci_error;
+        int error;
+
+        static const char *SEEK_strs[] = {"absolute", "relative", 0};
+        enum SEEK_enum { SEEK_ABSOLUTE, SEEK_RELATIVE };
+
+        if (objc != 4) {
+            Tcl_WrongNumArgs(interp, 2, objv,
+                             choice == STMT_CURSOR ? "offset pos"
+                                                   : "absolute|relative row");
+            return TCL_ERROR;
+        }
+
+        if (choice == STMT_CURSOR) {
+            if (Tcl_GetIntFromObj(interp, objv[2], &offset) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            /*
+             * The index is kept in the object, so a literal origin is
+             * looked up only once.
+             */
+            if (Tcl_GetIndexFromObj(interp, objv[3], cursorOriginStrs, "pos",
+                                    TCL_EXACT, &index) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            origin = cursorOrigins[index];
+        } else {
+            if (Tcl_GetIndexFromObj(interp, objv[2], SEEK_strs, "origin", 0,
+                                    &index) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (Tcl_GetIntFromObj(interp, objv[3], &offset) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            /*
+             * Row n counts from 1, row -n from the end.
+             */
+            if (index == SEEK_RELATIVE) {
+                origin = CCI_CURSOR_CURRENT;
+            } else if (offset < 0) {
+                origin = CCI_CURSOR_LAST;
+                offset = -offset;
+            } else {
+                origin = CCI_CURSOR_FIRST;
+            }
+        }
+
+        error = CubridCursor(pStmt, offset, origin, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(0));
+            return TCL_OK;
+        }
+
+        if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+        break;
+    }
+
+    case STMT_POSITION:
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pStmt->position));
+        break;
+
+    case STMT_ROWCOUNT:
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pStmt->rowCount));
+        break;
+
+    case STMT_FETCH_ROW_LIST:
+    case STMT_FETCH_ROW_DICT: {
+        Tcl_Obj *pResultStr = NULL;
+
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        if (CubridGetRow(interp, pDb, pStmt->request,
+                         (choice == STMT_FETCH_ROW_DICT), &pResultStr) !=
+            TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, pResultStr);
+        break;
+    }
+
+    case STMT_COLUMNS: {
+        T_CCI_COL_INFO *col_info;
+        T_CCI_CUBRID_STMT stmt_type;
+        char *name;
+        int col_count = 0;
+        int i = 0;
+        Tcl_Obj *pResultStr;
+
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        pResultStr = Tcl_NewListObj(0, NULL);
+
+        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+        if (col_info == NULL) {
+            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
+            return TCL_ERROR;
+        }
+
+        for (i = 1; i <= col_count; i++) {
+            name = CCI_GET_RESULT_INFO_NAME(col_info, i);
+            Tcl_ListObjAppendElement(interp, pResultStr,
+                                     Tcl_NewStringObj(name, -1));
+        }
+
+        Tcl_SetObjResult(interp, pResultStr);
+        break;
+    }
+
+    case STMT_COLUMNTYPE: {
+        T_CCI_COL_INFO *col_info;
+        T_CCI_CUBRID_STMT stmt_type;
+        T_CCI_U_TYPE type;
+        int col_count = 0;
+        int index = 0;
+        Tcl_Obj *pResultStr = NULL;
+
+        if (objc == 3) {
+            if (Tcl_GetIntFromObj(interp, objv[2], &index) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            if (index < 1) {
+                return TCL_ERROR;
+            }
+        } else {
+            Tcl_WrongNumArgs(interp, 2, objv, "index");
+            return TCL_ERROR;
+        }
+
+        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+        if (col_info == NULL) {
+            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
+            return TCL_ERROR;
+        }
+
+        if (index > col_count) {
+            Tcl_SetResult(interp, (char *)"column index out of range", NULL);
+            return TCL_ERROR;
+        }
+
+        type = CCI_GET_RESULT_INFO_TYPE(col_info, index);
+        pResultStr = Tcl_NewStringObj(CubridTypeName(type), -1);
+
+        Tcl_SetObjResult(interp, pResultStr);
+        break;
+    }
+
+    case STMT_PARAMTYPES: {
+        Tcl_Obj *pResultStr = NULL;
+        int i;
+
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        CubridLoadParamTypes(pStmt);
+
+        pResultStr = Tcl_NewListObj(0, NULL);
+        for (i = 0; i < pStmt->paramCount; i++) {
+            Tcl_ListObjAppendElement(interp, pResultStr,
+                Tcl_NewStringObj(cubridTypes[pStmt->paramTypes[i]].name, -1));
+        }
+
+        Tcl_SetObjResult(interp, pResultStr);
+        break;
+    }
+
+    case STMT_EXPORT:
+        rc = CubridExportCmd(interp, pStmt, objc, objv);
+        break;
+
+    case STMT_IMPORT:
+        rc = CubridImportCmd(interp, pStmt, objc, objv);
+        break;
+
+    case STMT_FETCH_JSON:
+        rc = CubridFetchJsonCmd(interp, pStmt, objc, objv);
+        break;
+
+    case STMT_CONFIGURE: {
+        int option;
+        int maxRows;
+        int i;
+
+        static const char *CONF_strs[] = {"-maxrows", 0};
+        enum CONF_enum { CONF_MAXROWS };
+
+        if (objc == 2) {
+            Tcl_Obj *resultPtr = Tcl_NewListObj(0, NULL);
+
+            Tcl_ListObjAppendElement(NULL, resultPtr,
+                                     Tcl_NewStringObj("-maxrows", -1));
+            Tcl_ListObjAppendElement(NULL, resultPtr,
+                                     Tcl_NewIntObj(pStmt->maxRows));
+            Tcl_SetObjResult(interp, resultPtr);
+            break;
+        }
+
+        if (objc == 3) {
+            if (Tcl_GetIndexFromObj(interp, objv[2], CONF_strs, "option", 0,
+                                    &option) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, Tcl_NewIntObj(pStmt->maxRows));
+            break;
+        }
+
+        if ((objc & 1) != 0) {
+            Tcl_WrongNumArgs(interp, 2, objv, "?-option value ...?");
+            return TCL_ERROR;
+        }
+
+        for (i = 2; i < objc; i += 2) {
+            if (Tcl_GetIndexFromObj(interp, objv[i], CONF_strs, "option", 0,
+                                    &option) != TCL_OK) {
+                return TCL_ERROR;
+            }
+
+            switch ((enum CONF_enum)option) {
+            case CONF_MAXROWS:
+                if (CubridGetMaxRows(interp, objv[i + 1], &maxRows) !=
+                    TCL_OK) {
+                    return TCL_ERROR;
+                }
+
+                /*
+                 * Applies to the next execute.
+                 */
+                pStmt->maxRows = maxRows;
+                if (CubridApplyMaxRows(pStmt) < 0) {
+                    Tcl_SetResult(interp, (char *)"set max rows failed",
+                                  NULL);
+                    return TCL_ERROR;
+                }
+                break;
+            }
+        }
+        break;
+    }
+
+    case STMT_TRUNCATED:
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(pStmt->truncated));
+        break;
+
+    case STMT_CLOSE: {
+        Tcl_Obj *return_obj;
+
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        if (cci_close_req_handle(pStmt->request) < 0) {
+            return_obj = Tcl_NewBooleanObj(0);
+        } else {
+            return_obj = Tcl_NewBooleanObj(1);
+        }
+
+        pStmt->request = 0;
+
+        Tcl_DeleteCommandFromToken(interp, pStmt->cmd);
+        Tcl_SetObjResult(interp, return_obj);
+
+        break;
+    }
+    }
+
+    return rc;
+}
+
+/*
+ * TDBC result set methods implemented in C.
+ *
+ * tdbc::cubrid::resultset attaches its statement handle and row count to
+ * the object as metadata, so nextlist/nextdict do not pay for upvar, catch
+ * and a Tcl level cursor/fetch call pair on every row.
+ */
+typedef struct ResultSetData {
+    Tcl_Obj *stmtName; /* STMT_HANDLE of the result set */
+    int rowCount;      /* rows affected by the statement */
+} ResultSetData;
+
+static void DeleteResultSetMetadata(ClientData clientData) {
+    ResultSetData *rdata = (ResultSetData *)clientData;
+
+    Tcl_DecrRefCount(rdata->stmtName);
+    ckfree((char *)rdata);
+}
+
+static int CloneResultSetMetadata(Tcl_Interp *interp, ClientData srcData,
+                                  ClientData *dstDataPtr) {
+    ResultSetData *src = (ResultSetData *)srcData;
+    ResultSetData *dst = (ResultSetData *)ckalloc(sizeof(ResultSetData));
+
+    dst->stmtName = src->stmtName;
+    Tcl_IncrRefCount(dst->stmtName);
+    dst->rowCount = src->rowCount;
+    *dstDataPtr = dst;
+
+    return TCL_OK;
+}
+
+static const Tcl_ObjectMetadataType resultSetDataType = {
+    TCL_OO_METADATA_VERSION_CURRENT,
+    "CubridResultSetData",
+    DeleteResultSetMetadata,
+    CloneResultSetMetadata
+};
+
+static ResultSetData *GetResultSetData(Tcl_Interp *interp,
+                                       Tcl_ObjectContext context) {
+    Tcl_Object object = Tcl_ObjectContextObject(context);
+    ResultSetData *rdata;
+
+    rdata = (ResultSetData *)Tcl_ObjectGetMetadata(object, &resultSetDataType);
+    if (rdata == NULL) {
+        Tcl_SetResult(interp, (char *)"result set is not attached", NULL);
+    }
+
+    return rdata;
+}
+
+/*
+ * my attach STMT_HANDLE rowcount
+ */
+static int ResultSetAttachMethod(ClientData clientData, Tcl_Interp *interp,
+                                 Tcl_ObjectContext context, int objc,
+                                 Tcl_Obj *const *objv) {
+    Tcl_Object object = Tcl_ObjectContextObject(context);
+    int skip = Tcl_ObjectContextSkippedArgs(context);
+    ResultSetData *rdata;
+    int rowCount;
+
+    if (objc != skip + 2) {
+        Tcl_WrongNumArgs(interp, skip, objv, "stmtHandle rowcount");
+        return TCL_ERROR;
+    }
+
+    if (Tcl_GetIntFromObj(interp, objv[skip + 1], &rowCount) != TCL_OK) {
+        return TCL_ERROR;
+    }
+
+    rdata = (ResultSetData *)ckalloc(sizeof(ResultSetData));
+    rdata->stmtName = objv[skip];
+    Tcl_IncrRefCount(rdata->stmtName);
+    rdata->rowCount = rowCount;
+
+    /*
+     * Replacing the metadata deletes the old one.
+     */
+    Tcl_ObjectSetMetadata(object, &resultSetDataType, rdata);
+
+    return TCL_OK;
+}
+
+/*
+ * $resultset nextlist varName / $resultset nextdict varName
+ */
+static int ResultSetNextRowMethod(ClientData clientData, Tcl_Interp *interp,
+                                  Tcl_ObjectContext context, int objc,
+                                  Tcl_Obj *const *objv) {
+    int asDict = (int)(intptr_t)clientData;
+    int skip = Tcl_ObjectContextSkippedArgs(context);
+    ResultSetData *rdata;
+    CUBRIDStmt *pStmt;
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    int col_count = 0;
+    int error;
+    int found = 0;
+    Tcl_Obj *pRow = NULL;
+
+    if (objc != skip + 1) {
+        Tcl_WrongNumArgs(interp, skip, objv, "varName");
+        return TCL_ERROR;
+    }
+
+    rdata = GetResultSetData(interp, context);
+    if (rdata == NULL) {
+        return TCL_ERROR;
+    }
+
+    pStmt = CubridFindStmt(interp, Tcl_GetString(rdata->stmtName), NULL);
+    if (pStmt == NULL) {
+        return TCL_ERROR;
+    }
+
+    /*
+     * Statements without a result set (INSERT, UPDATE, ...) have no rows.
+     */
+    col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+    if (col_info == NULL || col_count == 0) {
+        pRow = Tcl_NewObj();
+    } else {
+        error = CubridCursor(pStmt, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            pRow = Tcl_NewObj();
+        } else if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            return TCL_ERROR;
+        } else if (CubridGetRow(interp, pStmt->pDb, pStmt->request, asDict,
+                                &pRow) != TCL_OK) {
+            return TCL_ERROR;
+        } else {
+            found = 1;
+        }
+    }
+
+    if (Tcl_ObjSetVar2(interp, objv[skip], NULL, pRow, TCL_LEAVE_ERR_MSG) ==
+        NULL) {
+        return TCL_ERROR;
+    }
+
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(found));
+    return TCL_OK;
+}
+
+/*
+ * $resultset nextresults
+ */
+static int ResultSetNextResultsMethod(ClientData clientData,
+                                      Tcl_Interp *interp,
+                                      Tcl_ObjectContext context, int objc,
+                                      Tcl_Obj *const *objv) {
+    int skip = Tcl_ObjectContextSkippedArgs(context);
+    ResultSetData *rdata;
+    CUBRIDStmt *pStmt;
+    int count = 0;
+    int res;
+
+    if (objc != skip) {
+        Tcl_WrongNumArgs(interp, skip, objv, 0);
+        return TCL_ERROR;
+    }
+
+    rdata = GetResultSetData(interp, context);
+    if (rdata == NULL) {
+        return TCL_ERROR;
+    }
+
+    pStmt = CubridFindStmt(interp, Tcl_GetString(rdata->stmtName), NULL);
+    if (pStmt == NULL) {
+        return TCL_ERROR;
+    }
+
+    res = CubridNextResult(interp, pStmt, &count);
+    if (res < 0) {
+        return TCL_ERROR;
+    }
+    if (res > 0) {
+        rdata->rowCount = count;
+    }
+
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(res));
+    return TCL_OK;
+}
+
+/*
+ * $resultset rowcount
+ */
+static int ResultSetRowCountMethod(ClientData clientData, Tcl_Interp *interp,
+                                   Tcl_ObjectContext context, int objc,
+                                   Tcl_Obj *const *objv) {
+    int skip = Tcl_ObjectContextSkippedArgs(context);
+    ResultSetData *rdata;
+
+    if (objc != skip) {
+        Tcl_WrongNumArgs(interp, skip, objv, 0);
+        return TCL_ERROR;
+    }
+
+    rdata = GetResultSetData(interp, context);
+    if (rdata == NULL) {
+        return TCL_ERROR;
+    }
+
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(rdata->rowCount));
+    return TCL_OK;
+}
+
+static const Tcl_MethodType resultSetMethods[] = {
+    {TCL_OO_METHOD_VERSION_CURRENT, "attach", ResultSetAttachMethod, NULL,
+     NULL},
+    {TCL_OO_METHOD_VERSION_CURRENT, "nextlist", ResultSetNextRowMethod, NULL,
+     NULL},
+    {TCL_OO_METHOD_VERSION_CURRENT, "nextdict", ResultSetNextRowMethod, NULL,
+     NULL},
+    {TCL_OO_METHOD_VERSION_CURRENT, "nextresults",
+     ResultSetNextResultsMethod, NULL, NULL},
+    {TCL_OO_METHOD_VERSION_CURRENT, "rowcount", ResultSetRowCountMethod, NULL,
+     NULL}
+};
+
+/*
+ * cubrid::resultset_methods CLASS
+ *
+ * Install the C implemented result set methods into a TclOO class.
+ * library/tdbccubrid.tcl uses this for tdbc::cubrid::resultset.
+ */
+static int CUBRID_RESULTSET_METHODS(void *cd, Tcl_Interp *interp, int objc,
+                                    Tcl_Obj *const *objv) {
+    Tcl_Object object;
+    Tcl_Class cls;
+    Tcl_Obj *nameObj;
+    int i;
+
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "class");
+        return TCL_ERROR;
+    }
+
+    object = Tcl_GetObjectFromObj(interp, objv[1]);
+    if (object == NULL) {
+        return TCL_ERROR;
+    }
+
+    cls = Tcl_GetObjectAsClass(object);
+    if (cls == NULL) {
+        Tcl_AppendResult(interp, Tcl_GetString(objv[1]), " is not a class",
+                         (char *)0);
+        return TCL_ERROR;
+    }
+
+    for (i = 0; i < (int)(sizeof(resultSetMethods) / sizeof(resultSetMethods[0]));
+         i++) {
+        nameObj = Tcl_NewStringObj(resultSetMethods[i].name, -1);
+        Tcl_IncrRefCount(nameObj);
+
+        /*
+         * attach is only called by the constructor (my attach ...)
+         */
+        Tcl_NewMethod(interp, cls, nameObj, (i != 0), &resultSetMethods[i],
+                      (ClientData)(intptr_t)(strcmp(resultSetMethods[i].name,
+                                                    "nextdict") == 0));
+        Tcl_DecrRefCount(nameObj);
+    }
+
+    return TCL_OK;
+}
+
+/*
+ * Schema introspection (HANDLE schema) --
+ *
+ * cci_schema_info results are decoded with CubridGetRow and their columns
+ * renamed to the keys the TDBC metadata methods return. Results are kept
+ * per connection until "HANDLE schema invalidate" or until a statement on
+ * the connection changes a table or an index.
+ */
+
+enum {
+    SCHEMA_COPY,   /* value as is */
+    SCHEMA_TYPE,   /* CUBRID type code to type name */
+    SCHEMA_NOT,    /* 0/1 flag inverted */
+    SCHEMA_PLUS1,  /* 0-based position to 1-based */
+    SCHEMA_RULE,   /* referential action code to name */
+    SCHEMA_UNIQUE, /* constraint type to unique flag */
+    SCHEMA_ASC     /* A/D to ascending flag */
+};
+
+typedef struct CubridSchemaField {
+    const char *column; /* column of the cci_schema_info result */
+    const char *key;    /* key of the returned dict */
+    int conv;
+} CubridSchemaField;
+
+static const CubridSchemaField schemaColumnFields[] = {
+    {"NAME", "name", SCHEMA_COPY},
+    {"DOMAIN", "type", SCHEMA_TYPE},
+    {"PRECISION", "precision", SCHEMA_COPY},
+    {"SCALE", "scale", SCHEMA_COPY},
+    {"NON_NULL", "nullable", SCHEMA_NOT},
+    {"DEFAULT", "default", SCHEMA_COPY},
+    {NULL, NULL, 0}
+};
+
+static const CubridSchemaField schemaPrimaryKeyFields[] = {
+    {"CLASS_NAME", "tableName", SCHEMA_COPY},
+    {"ATTR_NAME", "columnName", SCHEMA_COPY},
+    {"KEY_SEQ", "ordinalPosition", SCHEMA_COPY},
+    {"KEY_NAME", "constraintName", SCHEMA_COPY},
+    {NULL, NULL, 0}
+};
+
+static const CubridSchemaField schemaForeignKeyFields[] = {
+    {"FK_NAME", "foreignConstraintName", SCHEMA_COPY},
+    {"FKTABLE_NAME", "foreignTableName", SCHEMA_COPY},
+    {"FKCOLUMN_NAME", "foreignColumnName", SCHEMA_COPY},
+    {"PK_NAME", "primaryConstraintName", SCHEMA_COPY},
+    {"PKTABLE_NAME", "primaryTableName", SCHEMA_COPY},
+    {"PKCOLUMN_NAME", "primaryColumnName", SCHEMA_COPY},
+    {"KEY_SEQ", "ordinalPosition", SCHEMA_COPY},
+    {"UPDATE_RULE", "updateAction", SCHEMA_RULE},
+    {"DELETE_RULE", "deleteAction", SCHEMA_RULE},
+    {NULL, NULL, 0}
+};
+
+static const CubridSchemaField schemaIndexFields[] = {
+    {"NAME", "indexName", SCHEMA_COPY},
+    {"ATTR_NAME", "columnName", SCHEMA_COPY},
+    {"TYPE", "unique", SCHEMA_UNIQUE},
+    {"PRIMARY_KEY", "primary", SCHEMA_COPY},
+    {"KEY_ORDER", "ordinalPosition", SCHEMA_PLUS1},
+    {"ASC_DESC", "ascending", SCHEMA_ASC},
+    {NULL, NULL, 0}
+};
+
+/*
+ * Same order as the JDBC importedKey* constants, which CCI follows.
+ */
+static const char *schemaRuleNames[] = {
+    "CASCADE", "RESTRICT", "SET NULL", "NO ACTION", "SET DEFAULT"
+};
+
+static Tcl_Obj *CubridSchemaConvert(Tcl_Obj *valuePtr, int conv) {
+    const char *str;
+    int n;
+
+    if (conv == SCHEMA_ASC) {
+        str = Tcl_GetString(valuePtr);
+        return Tcl_NewBooleanObj(str[0] != 'D' && str[0] != 'd');
+    }
+
+    if (conv == SCHEMA_COPY || Tcl_GetIntFromObj(NULL, valuePtr, &n) != TCL_OK) {
+        return valuePtr;
+    }
+
+    switch (conv) {
+    case SCHEMA_TYPE:
+        return Tcl_NewStringObj(CubridTypeName(n), -1);
+    case SCHEMA_NOT:
+        return Tcl_NewBooleanObj(!n);
+    case SCHEMA_PLUS1:
+        return Tcl_NewIntObj(n + 1);
+    case SCHEMA_RULE:
+        if (n >= 0 && n < (int)(sizeof(schemaRuleNames) / sizeof(char *))) {
+            return Tcl_NewStringObj(schemaRuleNames[n], -1);
+        }
+        return valuePtr;
+    case SCHEMA_UNIQUE:
+        /* 0 unique, 1 index, 2 reverse unique, 3 reverse index */
+        return Tcl_NewBooleanObj(n == 0 || n == 2);
+    }
+
+    return valuePtr;
+}
+
+static Tcl_Obj *CubridSchemaGet(Tcl_Obj *rowPtr, const char *column) {
+    Tcl_Obj *keyPtr = Tcl_NewStringObj(column, -1);
+    Tcl_Obj *valuePtr = NULL;
+
+    Tcl_IncrRefCount(keyPtr);
+    if (Tcl_DictObjGet(NULL, rowPtr, keyPtr, &valuePtr) != TCL_OK) {
+        valuePtr = NULL;
+    }
+    Tcl_DecrRefCount(keyPtr);
+
+    return valuePtr;
+}
+
+/*
+ * Build a dict from the raw row using fields. Columns the server did not
+ * send (or sent as NULL) are left out.
+ */
+static Tcl_Obj *CubridSchemaMap(Tcl_Obj *rowPtr,
+                                const CubridSchemaField *fields) {
+    Tcl_Obj *resultPtr = Tcl_NewDictObj();
+    Tcl_Obj *valuePtr;
+    int i;
+
+    for (i = 0; fields[i].column != NULL; i++) {
+        valuePtr = CubridSchemaGet(rowPtr, fields[i].column);
+        if (valuePtr != NULL) {
+            Tcl_DictObjPut(NULL, resultPtr,
+                           Tcl_NewStringObj(fields[i].key, -1),
+                           CubridSchemaConvert(valuePtr, fields[i].conv));
+        }
+    }
+
+    return resultPtr;
+}
+
+/*
+ * Run cci_schema_info and return its rows as a list of dicts keyed by the
+ * result column names. The list is returned with a reference held for the
+ * caller.
+ */
+static int CubridSchemaRows(Tcl_Interp *interp, CUBRIDDATA *pDb,
+                            T_CCI_SCH_TYPE type, char *arg1, char *arg2,
+                            char flag, Tcl_Obj **rowsPtr) {
+    T_CCI_ERROR cci_error;
+    Tcl_Obj *rowsObj;
+    Tcl_Obj *rowPtr;
+    int request;
+    int error;
+
+    request = cci_schema_info(pDb->connection, type, arg1, arg2, flag,
+                              &cci_error);
+    if (request < 0) {
+        Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        return TCL_ERROR;
+    }
+
+    rowsObj = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(rowsObj);
+
+    while (1) {
+        error = cci_cursor(request, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            break;
+        }
+        if (error < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            goto error;
+        }
+
+        if (CubridGetRow(interp, pDb, request, 1, &rowPtr) != TCL_OK) {
+            goto error;
+        }
+        Tcl_ListObjAppendElement(NULL, rowsObj, rowPtr);
+    }
+
+    cci_close_req_handle(request);
+    *rowsPtr = rowsObj;
+    return TCL_OK;
+
+error:
+    cci_close_req_handle(request);
+    Tcl_DecrRefCount(rowsObj);
+    return TCL_ERROR;
+}
+
+/*
+ * HANDLE schema tables ?pattern?
+ * HANDLE schema columns table ?pattern?
+ * HANDLE schema primarykeys table
+ * HANDLE schema foreignkeys ?-primary table? ?-foreign table?
+ * HANDLE schema indexes table
+ * HANDLE schema invalidate
+ */
+static int CubridSchemaCmd(Tcl_Interp *interp, CUBRIDDATA *pDb, int objc,
+                           Tcl_Obj *const *objv) {
+    int choice;
+    Tcl_Obj *keyPtr;
+    Tcl_Obj *rowsObj;
+    Tcl_Obj *resultPtr;
+    Tcl_Obj **rowPtrs;
+    Tcl_Obj *valuePtr;
+    Tcl_HashEntry *entry;
+    Tcl_Size rowCount, i;
+    int isNew;
+    int n;
+    char *primary = NULL;
+    char *foreign = NULL;
+    char *pattern;
+    T_CCI_SCH_TYPE type;
+    const CubridSchemaField *fields;
+
+    static const char *SCHEMA_strs[] = {
+        "tables",
+        "columns",
+        "primarykeys",
+        "foreignkeys",
+        "indexes",
+        "invalidate",
+        0
+    };
+
+    enum SCHEMA_enum {
+        SCHEMA_TABLES,
+        SCHEMA_COLUMNS,
+        SCHEMA_PRIMARYKEYS,
+        SCHEMA_FOREIGNKEYS,
+        SCHEMA_INDEXES,
+        SCHEMA_INVALIDATE
+    };
+
+    if (objc < 3) {
+        Tcl_WrongNumArgs(interp, 2, objv, "kind ?arg ...?");
+        return TCL_ERROR;
+    }
+
+    if (Tcl_GetIndexFromObj(interp, objv[2], SCHEMA_strs, "kind", 0,
+                            &choice)) {
+        return TCL_ERROR;
+    }
+
+    switch ((enum SCHEMA_enum)choice) {
+    case SCHEMA_TABLES:
+        if (objc > 4) {
+            Tcl_WrongNumArgs(interp, 3, objv, "?pattern?");
+            return TCL_ERROR;
+        }
+        break;
+    case SCHEMA_COLUMNS:
+        if (objc != 4 && objc != 5) {
+            Tcl_WrongNumArgs(interp, 3, objv, "table ?pattern?");
+            return TCL_ERROR;
+        }
+        break;
+    case SCHEMA_PRIMARYKEYS:
+    case SCHEMA_INDEXES:
+        if (objc != 4) {
+            Tcl_WrongNumArgs(interp, 3, objv, "table");
+            return TCL_ERROR;
+        }
+        break;
+    case SCHEMA_FOREIGNKEYS:
+        if ((objc & 1) != 1 || objc > 7) {
+            Tcl_WrongNumArgs(interp, 3, objv,
+                             "?-primary table? ?-foreign table?");
+            return TCL_ERROR;
+        }
+        for (n = 3; n + 1 < objc; n += 2) {
+            pattern = Tcl_GetString(objv[n]);
+            if (strcmp(pattern, "-primary") == 0) {
+                primary = Tcl_GetString(objv[n + 1]);
+            } else if (strcmp(pattern, "-foreign") == 0) {
+                foreign = Tcl_GetString(objv[n + 1]);
+            } else {
+                Tcl_AppendResult(interp, "unknown option: ", pattern,
+                                 (char *)0);
+                return TCL_ERROR;
+            }
+        }
+        if (primary == NULL && foreign == NULL) {
+            Tcl_SetResult(interp,
+                          (char *)"foreignkeys needs -primary or -foreign",
+                          NULL);
+            return TCL_ERROR;
+        }
+        break;
+    case SCHEMA_INVALIDATE:
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 3, objv, 0);
+            return TCL_ERROR;
+        }
+        CubridSchemaInvalidate(pDb);
+        return TCL_OK;
+    }
+
+    /*
+     * The arguments, as a list, are the cache key.
+     */
+    keyPtr = Tcl_NewListObj(objc - 2, objv + 2);
+    Tcl_IncrRefCount(keyPtr);
+    entry = Tcl_FindHashEntry(&pDb->schemaCache, Tcl_GetString(keyPtr));
+    if (entry != NULL) {
+        Tcl_DecrRefCount(keyPtr);
+        Tcl_SetObjResult(interp, (Tcl_Obj *)Tcl_GetHashValue(entry));
+        return TCL_OK;
+    }
+
+    switch ((enum SCHEMA_enum)choice) {
+    case SCHEMA_TABLES:
+        pattern = (objc == 4) ? Tcl_GetString(objv[3]) : "%";
+        if (CubridSchemaRows(interp, pDb, CCI_SCH_CLASS, pattern, NULL,
+                             CCI_CLASS_NAME_PATTERN_MATCH,
+                             &rowsObj) != TCL_OK) {
+            goto error;
+        }
+        break;
+    case SCHEMA_COLUMNS:
+        pattern = (objc == 5) ? Tcl_GetString(objv[4]) : "%";
+        if (CubridSchemaRows(interp, pDb, CCI_SCH_ATTRIBUTE,
+                             Tcl_GetString(objv[3]), pattern,
+                             CCI_ATTR_NAME_PATTERN_MATCH,
+                             &rowsObj) != TCL_OK) {
+            goto error;
+        }
+        break;
+    case SCHEMA_PRIMARYKEYS:
+    case SCHEMA_INDEXES:
+        type = (choice == SCHEMA_PRIMARYKEYS) ? CCI_SCH_PRIMARY_KEY
+                                              : CCI_SCH_CONSTRAINT;
+        if (CubridSchemaRows(interp, pDb, type, Tcl_GetString(objv[3]),
+                             NULL, 0, &rowsObj) != TCL_OK) {
+            goto error;
+        }
+        break;
+    case SCHEMA_FOREIGNKEYS:
+        if (primary != NULL && foreign != NULL) {
+            n = CubridSchemaRows(interp, pDb, CCI_SCH_CROSS_REFERENCE,
+                                 primary, foreign, 0, &rowsObj);
+        } else if (foreign != NULL) {
+            n = CubridSchemaRows(interp, pDb, CCI_SCH_IMPORTED_KEYS, foreign,
+                                 NULL, 0, &rowsObj);
+        } else {
+            n = CubridSchemaRows(interp, pDb, CCI_SCH_EXPORTED_KEYS, primary,
+                                 NULL, 0, &rowsObj);
+        }
+        if (n != TCL_OK) {
+            goto error;
+        }
+        break;
+    case SCHEMA_INVALIDATE:
+        break;
+    }
+
+    Tcl_ListObjGetElements(NULL, rowsObj, &rowCount, &rowPtrs);
+
+    if (choice == SCHEMA_TABLES || choice == SCHEMA_COLUMNS) {
+        /*
+         * A dict keyed by name, as tdbc::connection tables/columns return.
+         */
+        resultPtr = Tcl_NewDictObj();
+        for (i = 0; i < rowCount; i++) {
+            valuePtr = CubridSchemaGet(rowPtrs[i], "NAME");
+            if (valuePtr == NULL) {
+                continue;
+            }
+
+            if (choice == SCHEMA_TABLES) {
+                Tcl_Obj *typePtr;
+                Tcl_Obj *tablePtr;
+
+                /* TYPE: 0 system class, 1 view, 2 table */
+                n = 2;
+                typePtr = CubridSchemaGet(rowPtrs[i], "TYPE");
+                if (typePtr != NULL) {
+                    Tcl_GetIntFromObj(NULL, typePtr, &n);
+                }
+                if (n == 0) {
+                    continue;
+                }
+
+                tablePtr = Tcl_NewDictObj();
+                Tcl_DictObjPut(NULL, tablePtr, Tcl_NewStringObj("name", -1),
+                               valuePtr);
+                Tcl_DictObjPut(NULL, tablePtr, Tcl_NewStringObj("type", -1),
+                               Tcl_NewStringObj(n == 1 ? "view" : "table",
+                                                -1));
+                Tcl_DictObjPut(NULL, resultPtr, valuePtr, tablePtr);
+            } else {
+                Tcl_DictObjPut(NULL, resultPtr, valuePtr,
+                               CubridSchemaMap(rowPtrs[i], schemaColumnFields));
+            }
+        }
+    } else {
+        /*
+         * A list of dicts, one per key column.
+         */
+        if (choice == SCHEMA_PRIMARYKEYS) {
+            fields = schemaPrimaryKeyFields;
+        } else if (choice == SCHEMA_FOREIGNKEYS) {
+            fields = schemaForeignKeyFields;
+        } else {
+            fields = schemaIndexFields;
+        }
+
+        resultPtr = Tcl_NewListObj(0, NULL);
+        for (i = 0; i < rowCount; i++) {
+            valuePtr = CubridSchemaMap(rowPtrs[i], fields);
+            if (choice == SCHEMA_INDEXES) {
+                Tcl_DictObjPut(NULL, valuePtr,
+                               Tcl_NewStringObj("tableName", -1), objv[3]);
+            }
+            Tcl_ListObjAppendElement(NULL, resultPtr, valuePtr);
+        }
+    }
+    Tcl_DecrRefCount(rowsObj);
+
+    entry = Tcl_CreateHashEntry(&pDb->schemaCache, Tcl_GetString(keyPtr),
+                                &isNew);
+    Tcl_IncrRefCount(resultPtr);
+    Tcl_SetHashValue(entry, resultPtr);
+    Tcl_DecrRefCount(keyPtr);
+
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+
+error:
+    Tcl_DecrRefCount(keyPtr);
+    return TCL_ERROR;
+}
+
+/*
+ * Switch autocommit mode, skipping the CCI call if the connection is
+ * already in that mode.
+ */
+static int CubridSetAutocommit(CUBRIDDATA *pDb, int autocommit) {
+    int res;
+
+    autocommit = (autocommit != 0);
+    if (pDb->autocommit == autocommit) {
+        return 0;
+    }
+
+    res = cci_set_autocommit(pDb->connection, autocommit
+                                                  ? CCI_AUTOCOMMIT_TRUE
+                                                  : CCI_AUTOCOMMIT_FALSE);
+    if (res == 0) {
+        pDb->autocommit = autocommit;
+    }
+
+    return res;
+}
+
+/*
+ * Isolation level names, in TRAN_* order starting at TRAN_READ_COMMITTED.
+ */
+#define CUBRID_ISOLATION_BASE TRAN_READ_COMMITTED
+
+static const char *isolationStrs[] = {
+    "readcommitted",
+    "repeatableread",
+    "serializable",
+    0
+};
+
+static int CubridGetIsolation(CUBRIDDATA *pDb, int refresh, int *levelPtr,
+                              T_CCI_ERROR *errPtr) {
+    int level;
+    int res;
+
+    if (pDb->isolation == 0 || refresh) {
+        res = cci_get_db_parameter(pDb->connection, CCI_PARAM_ISOLATION_LEVEL,
+                                   (void *)&level, errPtr);
+        if (res < 0) {
+            return res;
+        }
+        pDb->isolation = level;
+    }
+
+    *levelPtr = pDb->isolation;
+    return 0;
+}
+
+static int CubridSetIsolation(CUBRIDDATA *pDb, int level,
+                              T_CCI_ERROR *errPtr) {
+    int res;
+
+    if (pDb->isolation == level) {
+        return 0;
+    }
+
+    res = cci_set_db_parameter(pDb->connection, CCI_PARAM_ISOLATION_LEVEL,
+                               (void *)&level, errPtr);
+    if (res < 0) {
+        return res;
+    }
+
+    pDb->isolation = level;
+    return 0;
+}
+
+/*
+ * Parse the optional -refresh of the get commands.
+ */
+static int CubridGetRefresh(Tcl_Interp *interp, int objc,
+                            Tcl_Obj *const *objv, int *refreshPtr) {
+    *refreshPtr = 0;
+
+    if (objc == 3 && strcmp(Tcl_GetString(objv[2]), "-refresh") == 0) {
+        *refreshPtr = 1;
+    } else if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-refresh?");
+        return TCL_ERROR;
+    }
+
+    return TCL_OK;
+}
+
+/*
+ * The connection was closed by the script of HANDLE transaction.
+ */
+static int CubridTransactionClosed(Tcl_Interp *interp, int code) {
+    if (code == TCL_ERROR) {
+        return code;
+    }
+
+    Tcl_SetResult(interp,
+                  (char *)"connection closed inside a transaction, "
+                          "the transaction was rolled back",
+                  NULL);
+    return TCL_ERROR;
+}
+
+/*
+ * HANDLE transaction ?-isolation level? script
+ *
+ * The outermost call turns autocommit off, commits if the script completes
+ * (any code but TCL_ERROR, as tdbc::connection transaction does) and rolls
+ * back otherwise. A nested call runs the script under a savepoint and
+ * rolls back to it on error.
+ *
+ * The script may close the connection. pDb is preserved while it runs, and
+ * nothing is committed or restored if the connection is gone; the
+ * disconnect has rolled the transaction back, which is an error unless the
+ * script failed anyway.
+ */
+static int CubridTransactionCmd(Tcl_Interp *interp, CUBRIDDATA *pDb, int objc,
+                                Tcl_Obj *const *objv) {
+    T_CCI_ERROR cci_error;
+    Tcl_InterpState state;
+    char savepoint[32 + TCL_INTEGER_SPACE];
+    int oldLevel = 0;
+    int level = 0;
+    int wasAutocommit;
+    int index;
+    int code;
+    int res;
+
+    if (objc == 5) {
+        if (strcmp(Tcl_GetString(objv[2]), "-isolation") != 0) {
+            Tcl_AppendResult(interp, "unknown option: ", Tcl_GetString(objv[2]),
+                             (char *)0);
+            return TCL_ERROR;
+        }
+
+        if (Tcl_GetIndexFromObj(interp, objv[3], isolationStrs,
+                                "isolation level", 0, &index)) {
+            return TCL_ERROR;
+        }
+
+        level = index + CUBRID_ISOLATION_BASE;
+    } else if (objc != 3) {
+        Tcl_WrongNumArgs(interp, 2, objv, "?-isolation level? script");
+        return TCL_ERROR;
+    }
+
+    if (pDb->txDepth > 0) {
+        if (level != 0) {
+            Tcl_SetResult(interp,
+                          (char *)"cannot change isolation level inside a "
+                                  "transaction",
+                          NULL);
+            return TCL_ERROR;
+        }
+
+        sprintf(savepoint, "tclcubrid_sp%d", pDb->txDepth);
+        if (cci_savepoint(pDb->connection, CCI_SP_SET, savepoint,
+                          &cci_error) < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            return TCL_ERROR;
+        }
+
+        pDb->txDepth++;
+        Tcl_Preserve((ClientData)pDb);
+        code = Tcl_EvalObjEx(interp, objv[objc - 1], 0);
+        pDb->txDepth--;
+
+        if (pDb->connection <= 0) {
+            code = CubridTransactionClosed(interp, code);
+        } else if (code == TCL_ERROR) {
+            state = Tcl_SaveInterpState(interp, code);
+            cci_savepoint(pDb->connection, CCI_SP_ROLLBACK, savepoint,
+                          &cci_error);
+            code = Tcl_RestoreInterpState(interp, state);
+        }
+
+        Tcl_Release((ClientData)pDb);
+        return code;
+    }
+
+    if (level != 0) {
+        if (CubridGetIsolation(pDb, 0, &oldLevel, &cci_error) < 0 ||
+            CubridSetIsolation(pDb, level, &cci_error) < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            return TCL_ERROR;
+        }
+    }
+
+    wasAutocommit = pDb->autocommit;
+    res = CubridSetAutocommit(pDb, 0);
+    if (res != 0) {
+        if (cci_get_err_msg(res, cci_error.err_msg,
+                            (int)sizeof(cci_error.err_msg)) < 0) {
+            Tcl_SetResult(interp, (char *)"set autocommit failed", NULL);
+        } else {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        }
+        if (level != 0) {
+            CubridSetIsolation(pDb, oldLevel, &cci_error);
+        }
+        return TCL_ERROR;
+    }
+
+    pDb->txDepth++;
+    Tcl_Preserve((ClientData)pDb);
+    code = Tcl_EvalObjEx(interp, objv[objc - 1], 0);
+    pDb->txDepth--;
+
+    if (pDb->connection <= 0) {
+        code = CubridTransactionClosed(interp, code);
+        Tcl_Release((ClientData)pDb);
+        return code;
+    }
+
+    if (code != TCL_ERROR) {
+        res = cci_end_tran(pDb->connection, CCI_TRAN_COMMIT, &cci_error);
+        if (res < 0) {
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            code = TCL_ERROR;
+        }
+    } else {
+        state = Tcl_SaveInterpState(interp, code);
+        cci_end_tran(pDb->connection, CCI_TRAN_ROLLBACK, &cci_error);
+        code = Tcl_RestoreInterpState(interp, state);
+    }
+
+    CubridSetAutocommit(pDb, wasAutocommit);
+    if (level != 0) {
+        CubridSetIsolation(pDb, oldLevel, &cci_error);
+    }
+
+    Tcl_Release((ClientData)pDb);
+    return code;
+}
+
+/*
+ * HANDLE paginate keeps its prepared statements here, by generated SQL.
+ * They have no command; the cache is emptied when it is full and when the
+ * connection is closed.
+ */
+#define CUBRID_PAGE_CACHE_SIZE 32
+
+static void CubridPageCacheClear(CUBRIDDATA *pDb) {
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entry;
+    CUBRIDStmt *pStmt;
+
+    for (entry = Tcl_FirstHashEntry(&pDb->pageCache, &search); entry != NULL;
+         entry = Tcl_NextHashEntry(&search)) {
+        pStmt = (CUBRIDStmt *)Tcl_GetHashValue(entry);
+        if (pStmt->request > 0 && pDb->connection > 0) {
+            cci_close_req_handle(pStmt->request);
+        }
+        CubridFreeLobLinks(pStmt);
+        if (pStmt->paramTypes) {
+            ckfree((char *)pStmt->paramTypes);
+        }
+        if (pStmt->scratch) {
+            ckfree(pStmt->scratch);
+        }
+        ckfree(pStmt);
+    }
+
+    Tcl_DeleteHashTable(&pDb->pageCache);
+    Tcl_InitHashTable(&pDb->pageCache, TCL_STRING_KEYS);
+}
+
+/*
+ * HANDLE paginate sql -orderby columns -pagesize n ?-after key?
+ *
+ * Return a page of the rows of sql in keyset (seek method) order: the
+ * rows after key, the values of the -orderby columns in the last row of
+ * the page before, so the server finds the page with the ORDER BY index
+ * instead of reading and skipping OFFSET rows. The result is a dict with
+ * the rows (as lists) and next, the key of the next page, which is empty
+ * after the last page.
+ */
+static int CubridPaginateCmd(Tcl_Interp *interp, CUBRIDDATA *pDb, int objc,
+                             Tcl_Obj *const *objv) {
+    Tcl_Obj *orderPtr = NULL;
+    Tcl_Obj *afterPtr = NULL;
+    Tcl_Obj **colPtrs, **wordPtrs, **keyPtrs = NULL;
+    Tcl_Obj *rowsPtr, *rowPtr, *nextPtr, *resultPtr;
+    Tcl_Obj *lastRowPtr = NULL;
+    Tcl_Obj **valuePtrs;
+    Tcl_DString sql;
+    Tcl_HashEntry *entry;
+    CUBRIDStmt *pStmt;
+    T_CCI_COL_INFO *col_info;
+    T_CCI_CUBRID_STMT stmt_type;
+    T_CCI_ERROR cci_error;
+    Tcl_Size colCount, wordCount, keyCount = 0, valueCount;
+    const char **names = NULL;
+    int *keyIndexes = NULL;
+    int *descending = NULL;
+    int pageSize = 0;
+    int col_count = 0;
+    int option, isNew;
+    int i, j, k, index;
+    int rows = 0;
+    int error;
+    int rc = TCL_ERROR;
+    const char *name, *p;
+    char limit[TCL_INTEGER_SPACE];
+
+    static const char *PAGE_strs[] = {"-orderby", "-pagesize", "-after", 0};
+    enum PAGE_enum { PAGE_ORDERBY, PAGE_PAGESIZE, PAGE_AFTER };
+
+    if (objc < 3 || (objc & 1) == 0) {
+        Tcl_WrongNumArgs(interp, 2, objv,
+                         "sql -orderby columns -pagesize n ?-after key?");
+        return TCL_ERROR;
+    }
 
-                    if (ind < 0) {
-                        /*
-                         * If a value is NULL, the returned dictionary for the
-                         * row will not contain the corresponding key.
-                         */
-                    } else {
-                        Tcl_DictObjPut(interp, pResultStr,
-                                       Tcl_NewStringObj(name, -1),
-                                       Tcl_NewStringObj(res_buf, -1));
-                    }
-                }
+    for (i = 3; i < objc; i += 2) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], PAGE_strs, "option", 0,
+                                &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
 
-                break;
+        switch ((enum PAGE_enum)option) {
+        case PAGE_ORDERBY:
+            orderPtr = objv[i + 1];
+            break;
+        case PAGE_PAGESIZE:
+            if (Tcl_GetIntFromObj(interp, objv[i + 1], &pageSize) != TCL_OK) {
+                return TCL_ERROR;
             }
+            break;
+        case PAGE_AFTER:
+            afterPtr = objv[i + 1];
+            break;
         }
+    }
 
-        Tcl_SetObjResult(interp, pResultStr);
-        break;
+    if (orderPtr == NULL ||
+        Tcl_ListObjGetElements(interp, orderPtr, &colCount, &colPtrs) !=
+            TCL_OK ||
+        colCount == 0) {
+        Tcl_SetResult(interp, (char *)"-orderby needs one or more columns",
+                      TCL_STATIC);
+        return TCL_ERROR;
     }
 
-    case STMT_COLUMNS: {
-        T_CCI_COL_INFO *col_info;
-        T_CCI_CUBRID_STMT stmt_type;
-        char *name;
-        int col_count = 0;
-        int i = 0;
-        Tcl_Obj *pResultStr;
+    if (pageSize <= 0 || pageSize == INT_MAX) {
+        Tcl_SetResult(interp, (char *)"-pagesize must be > 0", TCL_STATIC);
+        return TCL_ERROR;
+    }
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
+    if (afterPtr) {
+        if (Tcl_ListObjGetElements(interp, afterPtr, &keyCount, &keyPtrs) !=
+            TCL_OK) {
             return TCL_ERROR;
         }
-
-        pResultStr = Tcl_NewListObj(0, NULL);
-
-        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
-        if (col_info == NULL) {
-            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
+        if (keyCount != 0 && keyCount != colCount) {
+            Tcl_SetResult(interp,
+                          (char *)"-after needs one value per -orderby column",
+                          TCL_STATIC);
             return TCL_ERROR;
         }
-
-        for (i = 1; i <= col_count; i++) {
-            name = CCI_GET_RESULT_INFO_NAME(col_info, i);
-            Tcl_ListObjAppendElement(interp, pResultStr,
-                                     Tcl_NewStringObj(name, -1));
-        }
-
-        Tcl_SetObjResult(interp, pResultStr);
-        break;
     }
 
-    case STMT_COLUMNTYPE: {
-        T_CCI_COL_INFO *col_info;
-        T_CCI_CUBRID_STMT stmt_type;
-        T_CCI_U_TYPE type;
-        int col_count = 0;
-        int index = 0;
-        Tcl_Obj *pResultStr = NULL;
+    /*
+     * SELECT * FROM (sql) _page WHERE c1 > ? OR (c1 = ? AND c2 > ?) ...
+     * ORDER BY c1, c2 ... LIMIT n + 1, the extra row tells whether there
+     * is a next page. Column names are identifiers, optionally followed
+     * by ASC or DESC.
+     */
+    names = (const char **)ckalloc(sizeof(char *) * colCount);
+    descending = (int *)ckalloc(sizeof(int) * colCount);
+    keyIndexes = (int *)ckalloc(sizeof(int) * colCount);
+    for (i = 0; i < colCount; i++) {
+        if (Tcl_ListObjGetElements(NULL, colPtrs[i], &wordCount, &wordPtrs) !=
+                TCL_OK ||
+            wordCount < 1 || wordCount > 2) {
+            goto badColumn;
+        }
 
-        if (objc == 3) {
-            if (Tcl_GetIntFromObj(interp, objv[2], &index) != TCL_OK) {
-                return TCL_ERROR;
+        names[i] = Tcl_GetString(wordPtrs[0]);
+        if (names[i][0] == '\0') {
+            goto badColumn;
+        }
+        for (p = names[i]; *p; p++) {
+            if (!(*p == '_' || (*p >= 'a' && *p <= 'z') ||
+                  (*p >= 'A' && *p <= 'Z') ||
+                  (p != names[i] && *p >= '0' && *p <= '9'))) {
+                goto badColumn;
             }
+        }
 
-            if (index < 1) {
-                return TCL_ERROR;
+        descending[i] = 0;
+        if (wordCount == 2) {
+            name = Tcl_GetString(wordPtrs[1]);
+            if (Tcl_StringCaseMatch(name, "desc", 1)) {
+                descending[i] = 1;
+            } else if (!Tcl_StringCaseMatch(name, "asc", 1)) {
+                goto badColumn;
             }
-        } else {
-            Tcl_WrongNumArgs(interp, 2, objv, "index");
-            return TCL_ERROR;
         }
+    }
 
-        col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
-        if (col_info == NULL) {
-            Tcl_SetResult(interp, (char *)"get result info fail", NULL);
-            return TCL_ERROR;
+    Tcl_DStringInit(&sql);
+    Tcl_DStringAppend(&sql, "SELECT * FROM (", -1);
+    Tcl_DStringAppend(&sql, Tcl_GetString(objv[2]), -1);
+    Tcl_DStringAppend(&sql, ") _page", -1);
+    if (keyCount > 0) {
+        Tcl_DStringAppend(&sql, " WHERE ", -1);
+        for (i = 0; i < colCount; i++) {
+            Tcl_DStringAppend(&sql, i > 0 ? " OR (" : "(", -1);
+            for (j = 0; j < i; j++) {
+                Tcl_DStringAppend(&sql, names[j], -1);
+                Tcl_DStringAppend(&sql, " = ? AND ", -1);
+            }
+            Tcl_DStringAppend(&sql, names[i], -1);
+            Tcl_DStringAppend(&sql, descending[i] ? " < ?)" : " > ?)", -1);
         }
-
-        type = CCI_GET_RESULT_INFO_TYPE(col_info, index);
-        if (type == CCI_U_TYPE_CHAR) {
-            pResultStr = Tcl_NewStringObj("char", -1);
-        } else if (type == CCI_U_TYPE_STRING) {
-            pResultStr = Tcl_NewStringObj("varchar", -1);
-        } else if (type == CCI_U_TYPE_BIT) {
-            pResultStr = Tcl_NewStringObj("bit", -1);
-        } else if (type == CCI_U_TYPE_VARBIT) {
-            pResultStr = Tcl_NewStringObj("varbit", -1);
-        } else if (type == CCI_U_TYPE_NUMERIC) {
-            pResultStr = Tcl_NewStringObj("numeric", -1);
-        } else if (type == CCI_U_TYPE_INT) {
-            pResultStr = Tcl_NewStringObj("integer", -1);
-        } else if (type == CCI_U_TYPE_SHORT) {
-            pResultStr = Tcl_NewStringObj("smallint", -1);
-        } else if (type == CCI_U_TYPE_FLOAT) {
-            pResultStr = Tcl_NewStringObj("float", -1);
-        } else if (type == CCI_U_TYPE_DOUBLE) {
-            pResultStr = Tcl_NewStringObj("double", -1);
-        } else if (type == CCI_U_TYPE_MONETARY) {
-            pResultStr = Tcl_NewStringObj("monetary", -1);
-        } else if (type == CCI_U_TYPE_DATE) {
-            pResultStr = Tcl_NewStringObj("date", -1);
-        } else if (type == CCI_U_TYPE_TIME) {
-            pResultStr = Tcl_NewStringObj("time", -1);
-        } else if (type == CCI_U_TYPE_TIMESTAMP) {
-            pResultStr = Tcl_NewStringObj("timestamp", -1);
-        } else if (type == CCI_U_TYPE_TIMESTAMPTZ) {
-            pResultStr = Tcl_NewStringObj("timestamptz", -1);
-        } else if (type == CCI_U_TYPE_TIMESTAMPLTZ) {
-            pResultStr = Tcl_NewStringObj("timestampltz", -1);
-        } else if (type == CCI_U_TYPE_BIGINT) {
-            pResultStr = Tcl_NewStringObj("bigint", -1);
-        } else if (type == CCI_U_TYPE_DATETIME) {
-            pResultStr = Tcl_NewStringObj("datetime", -1);
-        } else if (type == CCI_U_TYPE_DATETIMETZ) {
-            pResultStr = Tcl_NewStringObj("datetimetz", -1);
-        } else if (type == CCI_U_TYPE_DATETIMELTZ) {
-            pResultStr = Tcl_NewStringObj("datetimeltz", -1);
-        } else if (type == CCI_U_TYPE_CLOB) {
-            pResultStr = Tcl_NewStringObj("clob", -1);
-        } else if (type == CCI_U_TYPE_BLOB) {
-            pResultStr = Tcl_NewStringObj("blob", -1);
-        } else if (CCI_IS_SET_TYPE(type)) {
-            pResultStr = Tcl_NewStringObj("set", -1);
-        } else if (CCI_IS_MULTISET_TYPE(type)) {
-            pResultStr = Tcl_NewStringObj("multiset", -1);
-        } else if (CCI_IS_SEQUENCE_TYPE(type)) {
-            pResultStr = Tcl_NewStringObj("sequence", -1);
-        } else if (type == CCI_U_TYPE_ENUM) {
-            pResultStr = Tcl_NewStringObj("enum", -1);
-        } else if (type == CCI_U_TYPE_JSON) {
-            pResultStr = Tcl_NewStringObj("json", -1);
-        } else {
-            pResultStr = Tcl_NewStringObj("", -1);
+    }
+    Tcl_DStringAppend(&sql, " ORDER BY ", -1);
+    for (i = 0; i < colCount; i++) {
+        if (i > 0) {
+            Tcl_DStringAppend(&sql, ", ", 2);
+        }
+        Tcl_DStringAppend(&sql, names[i], -1);
+        if (descending[i]) {
+            Tcl_DStringAppend(&sql, " DESC", -1);
         }
-
-        Tcl_SetObjResult(interp, pResultStr);
-        break;
     }
+    Tcl_DStringAppend(&sql, " LIMIT ", -1);
+    sprintf(limit, "%d", pageSize + 1);
+    Tcl_DStringAppend(&sql, limit, -1);
 
-    case STMT_CLOSE: {
-        Tcl_Obj *return_obj;
-        CLOBDataLink *clob_current, *clob_next;
-        BLOBDataLink *blob_current, *blob_next;
-
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
-            return TCL_ERROR;
+    /*
+     * Prepare once per generated statement.
+     */
+    entry = Tcl_FindHashEntry(&pDb->pageCache, Tcl_DStringValue(&sql));
+    if (entry == NULL) {
+        if (pDb->pageCache.numEntries >= CUBRID_PAGE_CACHE_SIZE) {
+            CubridPageCacheClear(pDb);
         }
 
-        if (cci_close_req_handle(pStmt->request) < 0) {
-            return_obj = Tcl_NewBooleanObj(0);
-        } else {
-            return_obj = Tcl_NewBooleanObj(1);
+        pStmt = (CUBRIDStmt *)ckalloc(sizeof(CUBRIDStmt));
+        memset(pStmt, 0, sizeof(CUBRIDStmt));
+        pStmt->request = cci_prepare(pDb->connection, Tcl_DStringValue(&sql),
+                                     0, &cci_error);
+        if (pStmt->request < 0) {
+            ckfree(pStmt);
+            Tcl_DStringFree(&sql);
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            goto done;
         }
+        pStmt->pDb = pDb;
+        pStmt->paramCount = -1;
+        pStmt->rowCount = -1;
 
-        pStmt->request = 0;
-
-        /*
-         * Check our BLOB/CLOB link again
-         */
-        if (pStmt->cloblink) {
-            clob_current = pStmt->cloblink;
-            while (clob_current) {
-                clob_next = clob_current->next;
-                cci_clob_free(clob_current->clob);
-                if (clob_current)
-                    free(clob_current);
-                clob_current = NULL;
-
-                clob_current = clob_next;
+        entry = Tcl_CreateHashEntry(&pDb->pageCache, Tcl_DStringValue(&sql),
+                                    &isNew);
+        Tcl_SetHashValue(entry, pStmt);
+    }
+    pStmt = (CUBRIDStmt *)Tcl_GetHashValue(entry);
+    Tcl_DStringFree(&sql);
+
+    if (keyCount > 0) {
+        CubridLoadParamTypes(pStmt);
+        index = 1;
+        for (i = 0; i < colCount; i++) {
+            for (j = 0; j <= i; j++, index++) {
+                if (CubridBindValue(interp, pStmt, index,
+                                    index <= pStmt->paramCount
+                                        ? pStmt->paramTypes[index - 1]
+                                        : CUBRID_TYPE_VARCHAR,
+                                    keyPtrs[j], 1) != TCL_OK) {
+                    goto done;
+                }
             }
         }
+    }
 
-        if (pStmt->bloblink) {
-            blob_current = pStmt->bloblink;
-            while (clob_current) {
-                blob_next = blob_current->next;
-                cci_blob_free(blob_current->blob);
-                if (blob_current)
-                    free(blob_current);
-                blob_current = NULL;
-
-                blob_current = blob_next;
+    error = cci_execute(pStmt->request, 0, 0, &cci_error);
+    CubridFreeLobLinks(pStmt);
+    if (error < 0) {
+        Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+        goto done;
+    }
+    CubridSetRowCount(pStmt, error);
+
+    col_info = cci_get_result_info(pStmt->request, &stmt_type, &col_count);
+    for (i = 0; i < colCount; i++) {
+        keyIndexes[i] = -1;
+        for (k = 1; k <= col_count; k++) {
+            if (Tcl_StringCaseMatch(CCI_GET_RESULT_INFO_NAME(col_info, k),
+                                    names[i], 1)) {
+                keyIndexes[i] = k - 1;
+                break;
             }
         }
+        if (keyIndexes[i] < 0) {
+            Tcl_SetObjResult(interp,
+                             Tcl_ObjPrintf("column \"%s\" is not in the result",
+                                           names[i]));
+            goto done;
+        }
+    }
 
-        Tcl_Free((char *)pStmt);
-        pStmt = 0;
-
-        Tcl_MutexLock(&myMutex);
-        if (hashEntryPtr)
-            Tcl_DeleteHashEntry(hashEntryPtr);
-        Tcl_MutexUnlock(&myMutex);
+    rowsPtr = Tcl_NewListObj(0, NULL);
+    Tcl_IncrRefCount(rowsPtr);
+    while (1) {
+        error = CubridCursor(pStmt, 1, CCI_CURSOR_CURRENT, &cci_error);
+        if (error == CCI_ER_NO_MORE_DATA) {
+            break;
+        }
+        if (error < 0) {
+            Tcl_DecrRefCount(rowsPtr);
+            Tcl_SetResult(interp, cci_error.err_msg, TCL_VOLATILE);
+            goto done;
+        }
 
-        Tcl_DeleteCommand(interp, Tcl_GetStringFromObj(objv[0], 0));
-        Tcl_SetObjResult(interp, return_obj);
+        if (rows == pageSize) {
+            /*
+             * The extra row: there is a next page.
+             */
+            rows++;
+            break;
+        }
 
-        break;
+        if (CubridGetRow(interp, pDb, pStmt->request, 0, &rowPtr) != TCL_OK) {
+            Tcl_DecrRefCount(rowsPtr);
+            goto done;
+        }
+        Tcl_ListObjAppendElement(NULL, rowsPtr, rowPtr);
+        lastRowPtr = rowPtr;
+        rows++;
     }
+
+    nextPtr = Tcl_NewListObj(0, NULL);
+    if (rows > pageSize) {
+        Tcl_ListObjGetElements(NULL, lastRowPtr, &valueCount, &valuePtrs);
+        for (i = 0; i < colCount; i++) {
+            Tcl_ListObjAppendElement(NULL, nextPtr,
+                                     keyIndexes[i] < valueCount
+                                         ? valuePtrs[keyIndexes[i]]
+                                         : Tcl_NewObj());
+        }
     }
 
+    resultPtr = Tcl_NewListObj(0, NULL);
+    Tcl_ListObjAppendElement(NULL, resultPtr, Tcl_NewStringObj("rows", -1));
+    Tcl_ListObjAppendElement(NULL, resultPtr, rowsPtr);
+    Tcl_ListObjAppendElement(NULL, resultPtr, Tcl_NewStringObj("next", -1));
+    Tcl_ListObjAppendElement(NULL, resultPtr, nextPtr);
+    Tcl_DecrRefCount(rowsPtr);
+    Tcl_SetObjResult(interp, resultPtr);
+    rc = TCL_OK;
+    goto done;
+
+badColumn:
+    Tcl_SetObjResult(interp, Tcl_ObjPrintf("bad -orderby column \"%s\"",
+                                           Tcl_GetString(colPtrs[i])));
+
+done:
+    if (names) {
+        ckfree((char *)names);
+    }
+    if (descending) {
+        ckfree(descending);
+    }
+    if (keyIndexes) {
+        ckfree(keyIndexes);
+    }
     return rc;
 }
 
@@ -1804,26 +5563,31 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
     int choice;
     int rc = TCL_OK;
 
-    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
-        &dataKey, sizeof(ThreadSpecificData));
-
-    if (tsdPtr->initialized == 0) {
-        tsdPtr->initialized = 1;
-        tsdPtr->cubrid_hashtblPtr =
-            (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
-        Tcl_InitHashTable(tsdPtr->cubrid_hashtblPtr, TCL_STRING_KEYS);
-    }
+    ThreadSpecificData *tsdPtr = CubridGetThreadData();
 
     static const char *DB_strs[] = {
         "getAutocommit",
         "setAutocommit",
         "getIsolationLevel",
         "setIsolationLevel",
+        "getLockTimeout",
+        "setLockTimeout",
+        "getHoldability",
+        "setHoldability",
+        "getBitFormat",
+        "setBitFormat",
+        "getLobFormat",
+        "setLobFormat",
+        "getMaxRows",
+        "setMaxRows",
         "commit",
         "rollback",
         "prepare",
         "server_version", "row_count",
         "last_insert_id",
+        "schema",
+        "paginate",
+        "transaction",
         "close",
         0
     };
@@ -1833,12 +5597,25 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
         DB_SETAUTOCOMMIT,
         DB_GETISOLATION,
         DB_SETISOLATION,
+        DB_GETLOCKTIMEOUT,
+        DB_SETLOCKTIMEOUT,
+        DB_GETHOLDABILITY,
+        DB_SETHOLDABILITY,
+        DB_GETBITFORMAT,
+        DB_SETBITFORMAT,
+        DB_GETLOBFORMAT,
+        DB_SETLOBFORMAT,
+        DB_GETMAXROWS,
+        DB_SETMAXROWS,
         DB_COMMIT,
         DB_ROLLBACK,
         DB_PREPARE,
         DB_VERSION,
         DB_ROW_COUNT,
         DB_LAST_INSERT_ID,
+        DB_SCHEMA,
+        DB_PAGINATE,
+        DB_TRANSACTION,
         DB_CLOSE,
     };
 
@@ -1857,25 +5634,23 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
 
     switch ((enum DB_enum)choice) {
     case DB_GETAUTOCOMMIT: {
-        CCI_AUTOCOMMIT_MODE mode = CCI_AUTOCOMMIT_TRUE;
+        int refresh;
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
+        if (CubridGetRefresh(interp, objc, objv, &refresh) != TCL_OK) {
             return TCL_ERROR;
         }
 
-        mode = cci_get_autocommit(pDb->connection);
-        if (mode == CCI_AUTOCOMMIT_TRUE) {
-            Tcl_SetObjResult(interp, Tcl_NewIntObj(1));
-        } else {
-            Tcl_SetObjResult(interp, Tcl_NewIntObj(0));
+        if (refresh) {
+            pDb->autocommit =
+                (cci_get_autocommit(pDb->connection) == CCI_AUTOCOMMIT_TRUE);
         }
+
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pDb->autocommit));
         break;
     }
 
     case DB_SETAUTOCOMMIT: {
         int autocommit = 0;
-        CCI_AUTOCOMMIT_MODE mode = CCI_AUTOCOMMIT_TRUE;
         Tcl_Obj *return_obj;
 
         if (objc == 3) {
@@ -1891,13 +5666,7 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
             return TCL_ERROR;
         }
 
-        if (autocommit == 0) {
-            mode = CCI_AUTOCOMMIT_FALSE;
-        } else {
-            mode = CCI_AUTOCOMMIT_TRUE;
-        }
-
-        if (cci_set_autocommit(pDb->connection, mode) != 0) {
+        if (CubridSetAutocommit(pDb, autocommit) != 0) {
             return_obj = Tcl_NewBooleanObj(0);
         } else {
             return_obj = Tcl_NewBooleanObj(1);
@@ -1908,71 +5677,238 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
     }
 
     case DB_GETISOLATION: {
-        T_CCI_DB_PARAM param_name = CCI_PARAM_ISOLATION_LEVEL;
         T_CCI_ERROR cci_error;
+        int refresh;
         int level;
-        int res;
 
-        if (objc != 2) {
-            Tcl_WrongNumArgs(interp, 2, objv, 0);
+        if (CubridGetRefresh(interp, objc, objv, &refresh) != TCL_OK) {
             return TCL_ERROR;
         }
 
-        res = cci_get_db_parameter(pDb->connection, param_name, (void *)&level,
-                                   &cci_error);
-        if (res < 0) {
+        if (CubridGetIsolation(pDb, refresh, &level, &cci_error) < 0) {
             Tcl_SetResult(interp, (char *)"Get value failed", TCL_STATIC);
             return TCL_ERROR;
+        }
+
+        level -= CUBRID_ISOLATION_BASE;
+        if (level >= 0 && level < 3) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj(isolationStrs[level], -1));
+        }
+
+        break;
+    }
+
+    case DB_SETISOLATION: {
+        T_CCI_ERROR cci_error;
+        int index;
+        Tcl_Obj *return_obj;
+
+        if (objc == 3) {
+            if (Tcl_GetIndexFromObj(interp, objv[2], isolationStrs,
+                                    "isolation level", 0, &index)) {
+                return TCL_ERROR;
+            }
+        } else {
+            Tcl_WrongNumArgs(interp, 2, objv, "level");
+            return TCL_ERROR;
+        }
+
+        if (CubridSetIsolation(pDb, index + CUBRID_ISOLATION_BASE,
+                               &cci_error) != 0) {
+            return_obj = Tcl_NewBooleanObj(0);
         } else {
-            if (level == 4) {
-                Tcl_SetObjResult(interp, Tcl_NewStringObj("readcommitted", -1));
-            } else if (level == 5) {
-                Tcl_SetObjResult(interp,
-                                 Tcl_NewStringObj("repeatableread", -1));
-            } else if (level == 6) {
-                Tcl_SetObjResult(interp, Tcl_NewStringObj("serializable", -1));
+            return_obj = Tcl_NewBooleanObj(1);
+        }
+
+        Tcl_SetObjResult(interp, return_obj);
+
+        break;
+    }
+
+    case DB_GETLOCKTIMEOUT: {
+        T_CCI_ERROR cci_error;
+        int refresh;
+        int timeout;
+
+        if (CubridGetRefresh(interp, objc, objv, &refresh) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        if (!pDb->haveLockTimeout || refresh) {
+            if (cci_get_db_parameter(pDb->connection, CCI_PARAM_LOCK_TIMEOUT,
+                                     (void *)&timeout, &cci_error) < 0) {
+                Tcl_SetResult(interp, (char *)"Get value failed", TCL_STATIC);
+                return TCL_ERROR;
             }
+            pDb->lockTimeout = timeout;
+            pDb->haveLockTimeout = 1;
         }
 
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pDb->lockTimeout));
         break;
     }
 
-    case DB_SETISOLATION: {
-        T_CCI_DB_PARAM param_name = CCI_PARAM_ISOLATION_LEVEL;
+    case DB_SETLOCKTIMEOUT: {
         T_CCI_ERROR cci_error;
-        int level = 0;
-        Tcl_Size len = 0;
-        char *setLevel = NULL;
+        int timeout;
         Tcl_Obj *return_obj;
 
+        /*
+         * Milliseconds, -1 waits forever.
+         */
         if (objc == 3) {
-            setLevel = Tcl_GetStringFromObj(objv[2], &len);
+            if (Tcl_GetIntFromObj(interp, objv[2], &timeout) != TCL_OK) {
+                return TCL_ERROR;
+            }
+        } else {
+            Tcl_WrongNumArgs(interp, 2, objv, "milliseconds");
+            return TCL_ERROR;
+        }
+
+        if (pDb->haveLockTimeout && pDb->lockTimeout == timeout) {
+            return_obj = Tcl_NewBooleanObj(1);
+        } else if (cci_set_db_parameter(pDb->connection,
+                                        CCI_PARAM_LOCK_TIMEOUT,
+                                        (void *)&timeout, &cci_error) != 0) {
+            return_obj = Tcl_NewBooleanObj(0);
+        } else {
+            pDb->lockTimeout = timeout;
+            pDb->haveLockTimeout = 1;
+            return_obj = Tcl_NewBooleanObj(1);
+        }
+
+        Tcl_SetObjResult(interp, return_obj);
+        break;
+    }
+
+    case DB_GETHOLDABILITY: {
+        int refresh;
+        int res;
+
+        if (CubridGetRefresh(interp, objc, objv, &refresh) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        if (refresh) {
+            res = cci_get_holdability(pDb->connection);
+            if (res < 0) {
+                Tcl_SetResult(interp, (char *)"Get value failed", TCL_STATIC);
+                return TCL_ERROR;
+            }
+            pDb->holdable = res;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pDb->holdable));
+        break;
+    }
+
+    case DB_SETHOLDABILITY: {
+        int holdable;
+        Tcl_Obj *return_obj;
 
-            if (!setLevel || len < 1) {
+        /*
+         * Whether cursors of new statements stay open after commit.
+         */
+        if (objc == 3) {
+            if (Tcl_GetBooleanFromObj(interp, objv[2], &holdable) != TCL_OK) {
                 return TCL_ERROR;
             }
         } else {
-            Tcl_WrongNumArgs(interp, 2, objv, "autocommit");
+            Tcl_WrongNumArgs(interp, 2, objv, "holdable");
+            return TCL_ERROR;
+        }
+
+        if (pDb->holdable == holdable) {
+            return_obj = Tcl_NewBooleanObj(1);
+        } else if (cci_set_holdability(pDb->connection, holdable) < 0) {
+            return_obj = Tcl_NewBooleanObj(0);
+        } else {
+            pDb->holdable = holdable;
+            return_obj = Tcl_NewBooleanObj(1);
+        }
+
+        Tcl_SetObjResult(interp, return_obj);
+        break;
+    }
+
+    case DB_GETBITFORMAT: {
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp,
+                         Tcl_NewStringObj(bitFormatStrs[pDb->bitFormat], -1));
+        break;
+    }
+
+    case DB_SETBITFORMAT: {
+        int format;
+
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "format");
+            return TCL_ERROR;
+        }
+
+        if (Tcl_GetIndexFromObj(interp, objv[2], bitFormatStrs, "bit format",
+                                0, &format)) {
+            return TCL_ERROR;
+        }
+
+        pDb->bitFormat = format;
+        break;
+    }
+
+    case DB_GETLOBFORMAT: {
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp,
+                         Tcl_NewStringObj(lobFormatStrs[pDb->lobFormat], -1));
+        break;
+    }
+
+    case DB_SETLOBFORMAT: {
+        int format;
+
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "format");
+            return TCL_ERROR;
+        }
+
+        if (Tcl_GetIndexFromObj(interp, objv[2], lobFormatStrs, "lob format",
+                                0, &format)) {
+            return TCL_ERROR;
+        }
+
+        pDb->lobFormat = format;
+        break;
+    }
+
+    case DB_GETMAXROWS: {
+        if (objc != 2) {
+            Tcl_WrongNumArgs(interp, 2, objv, 0);
             return TCL_ERROR;
         }
 
-        if (strcmp(setLevel, "readcommitted") == 0) {
-            level = 4;
-        } else if (strcmp(setLevel, "repeatableread") == 0) {
-            level = 5;
-        } else if (strcmp(setLevel, "serializable") == 0) {
-            level = 6;
-        }
+        Tcl_SetObjResult(interp, Tcl_NewIntObj(pDb->maxRows));
+        break;
+    }
 
-        if (cci_set_db_parameter(pDb->connection, param_name, (void *)&level,
-                                 &cci_error) != 0) {
-            return_obj = Tcl_NewBooleanObj(0);
-        } else {
-            return_obj = Tcl_NewBooleanObj(1);
+    case DB_SETMAXROWS: {
+        /*
+         * The default -maxrows of statements prepared afterwards.
+         */
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "rows");
+            return TCL_ERROR;
         }
 
-        Tcl_SetObjResult(interp, return_obj);
-
+        if (CubridGetMaxRows(interp, objv[2], &pDb->maxRows) != TCL_OK) {
+            return TCL_ERROR;
+        }
         break;
     }
 
@@ -2060,22 +5996,42 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
 
             return TCL_ERROR;
         } else {
+            pStmt->pDb = pDb;
             pStmt->cloblink = NULL;
             pStmt->bloblink = NULL;
+            pStmt->paramCount = -1;
+            pStmt->paramTypes = NULL;
+            pStmt->scratch = NULL;
+            pStmt->scratchSize = 0;
+            pStmt->rowCount = -1;
+            pStmt->position = 0;
+            pStmt->maxRows = pDb->maxRows;
+            pStmt->truncated = 0;
+            if (pStmt->maxRows > 0) {
+                CubridApplyMaxRows(pStmt);
+            }
 
-            Tcl_MutexLock(&myMutex);
-            sprintf(handleName, "cubrid_stat%d", tsdPtr->stmt_count++);
+            sprintf(handleName, "cubrid_stat%d_%d", tsdPtr->threadId,
+                    tsdPtr->stmt_count++);
 
             pResultStr = Tcl_NewStringObj(handleName, -1);
 
             newHashEntryPtr = Tcl_CreateHashEntry(tsdPtr->cubrid_hashtblPtr,
                                                   handleName, &newvalue);
             Tcl_SetHashValue(newHashEntryPtr, pStmt);
-            Tcl_MutexUnlock(&myMutex);
+            pStmt->entry = newHashEntryPtr;
 
-            Tcl_CreateObjCommand(interp, handleName,
-                                 (Tcl_ObjCmdProc *)CUBRID_STMT, (char *)pDb,
-                                 (Tcl_CmdDeleteProc *)NULL);
+            pStmt->prev = NULL;
+            pStmt->next = pDb->stmts;
+            if (pDb->stmts) {
+                pDb->stmts->prev = pStmt;
+            }
+            pDb->stmts = pStmt;
+
+            pStmt->interp = interp;
+            pStmt->cmd = Tcl_CreateObjCommand(interp, handleName,
+                                              (Tcl_ObjCmdProc *)CUBRID_STMT,
+                                              (char *)pStmt, StmtDeleteCmd);
         }
 
         Tcl_SetObjResult(interp, pResultStr);
@@ -2149,6 +6105,21 @@ static int DbObjCmd(void *cd, Tcl_Interp *interp, int objc,
         break;
     }
 
+    case DB_SCHEMA: {
+        rc = CubridSchemaCmd(interp, pDb, objc, objv);
+        break;
+    }
+
+    case DB_PAGINATE: {
+        rc = CubridPaginateCmd(interp, pDb, objc, objv);
+        break;
+    }
+
+    case DB_TRANSACTION: {
+        rc = CubridTransactionCmd(interp, pDb, objc, objv);
+        break;
+    }
+
     case DB_CLOSE: {
         if (objc != 2) {
             Tcl_WrongNumArgs(interp, 2, objv, 0);
@@ -2177,13 +6148,29 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
     char *password = NULL;
     char *properties = NULL;
     char connect_url[2048] = {'\0'};
+    char login_property[32 + TCL_INTEGER_SPACE] = {'\0'};
+    int isolation = 0;
+    int autocommit = -1;
+    int lockTimeout = 0;
+    int haveLockTimeout = 0;
+    int loginTimeout = -1;
+    int holdable = -1;
+    int bitFormat = CUBRID_BITS_BYTES;
+    int lobFormat = CUBRID_LOBS_VALUE;
+    int maxRows = 0;
+    int index;
+    int res = 0;
+    const char *preset = NULL;
     T_CCI_ERROR cci_error;
 
     if (objc < 2 || (objc & 1) != 0) {
         Tcl_WrongNumArgs(
             interp, 1, objv,
             "HANDLE ?-host HOST? ?-port PORT? ?-dbname DBNAME? ?-user "
-            "username? ?-passwd password? ?-property properties?");
+            "username? ?-passwd password? ?-property properties? "
+            "?-isolation level? ?-autocommit boolean? ?-locktimeout ms? "
+            "?-logintimeout ms? ?-holdable boolean? ?-bitformat format? "
+            "?-lobformat format? ?-maxrows n?");
         return TCL_ERROR;
     }
 
@@ -2214,6 +6201,52 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
             password = Tcl_GetStringFromObj(objv[i + 1], 0);
         } else if (strcmp(zArg, "-property") == 0) {
             properties = Tcl_GetStringFromObj(objv[i + 1], 0);
+        } else if (strcmp(zArg, "-isolation") == 0) {
+            if (Tcl_GetIndexFromObj(interp, objv[i + 1], isolationStrs,
+                                    "isolation level", 0, &index)) {
+                return TCL_ERROR;
+            }
+            isolation = index + CUBRID_ISOLATION_BASE;
+        } else if (strcmp(zArg, "-autocommit") == 0) {
+            if (Tcl_GetBooleanFromObj(interp, objv[i + 1], &autocommit) !=
+                TCL_OK) {
+                return TCL_ERROR;
+            }
+        } else if (strcmp(zArg, "-locktimeout") == 0) {
+            if (Tcl_GetIntFromObj(interp, objv[i + 1], &lockTimeout) !=
+                TCL_OK) {
+                return TCL_ERROR;
+            }
+            haveLockTimeout = 1;
+        } else if (strcmp(zArg, "-logintimeout") == 0) {
+            if (Tcl_GetIntFromObj(interp, objv[i + 1], &loginTimeout) !=
+                TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (loginTimeout < 0) {
+                Tcl_AppendResult(interp, "login timeout must be >= 0",
+                                 (char *)0);
+                return TCL_ERROR;
+            }
+        } else if (strcmp(zArg, "-holdable") == 0) {
+            if (Tcl_GetBooleanFromObj(interp, objv[i + 1], &holdable) !=
+                TCL_OK) {
+                return TCL_ERROR;
+            }
+        } else if (strcmp(zArg, "-bitformat") == 0) {
+            if (Tcl_GetIndexFromObj(interp, objv[i + 1], bitFormatStrs,
+                                    "bit format", 0, &bitFormat)) {
+                return TCL_ERROR;
+            }
+        } else if (strcmp(zArg, "-lobformat") == 0) {
+            if (Tcl_GetIndexFromObj(interp, objv[i + 1], lobFormatStrs,
+                                    "lob format", 0, &lobFormat)) {
+                return TCL_ERROR;
+            }
+        } else if (strcmp(zArg, "-maxrows") == 0) {
+            if (CubridGetMaxRows(interp, objv[i + 1], &maxRows) != TCL_OK) {
+                return TCL_ERROR;
+            }
         } else {
             Tcl_AppendResult(interp, "unknown option: ", zArg, (char *)0);
             return TCL_ERROR;
@@ -2241,15 +6274,9 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
         password = "";
     }
 
-    Tcl_MutexLock(&cubridMutex);
-    if (cubridRefCount == 0) {
-        if ((cubridLoadHandle = CubridInitStubs(interp)) == NULL) {
-            Tcl_MutexUnlock(&cubridMutex);
-            return TCL_ERROR;
-        }
+    if (CubridLibraryRetain(interp) != TCL_OK) {
+        return TCL_ERROR;
     }
-    ++cubridRefCount;
-    Tcl_MutexUnlock(&cubridMutex);
 
     p = (CUBRIDDATA *)Tcl_Alloc(sizeof(*p));
     if (p == 0) {
@@ -2259,9 +6286,23 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
 
     memset(p, 0, sizeof(*p));
 
+    /*
+     * The login timeout is a URL property, so it is part of the connect
+     * call itself.
+     */
+    if (loginTimeout >= 0) {
+        snprintf(login_property, sizeof(login_property), "login_timeout=%d",
+                 loginTimeout);
+    }
+
     if (properties && strlen(properties) > 0) {
-        snprintf(connect_url, sizeof(connect_url), "cci:CUBRID:%s:%d:%s:::?%s",
-                 host, port, dbname, properties);
+        snprintf(connect_url, sizeof(connect_url),
+                 "cci:CUBRID:%s:%d:%s:::?%s%s%s", host, port, dbname,
+                 properties, login_property[0] ? "&" : "", login_property);
+    } else if (login_property[0]) {
+        snprintf(connect_url, sizeof(connect_url),
+                 "cci:CUBRID:%s:%d:%s:::?%s", host, port, dbname,
+                 login_property);
     } else {
         snprintf(connect_url, sizeof(connect_url),
                  "cci:CUBRID:%s:%d:%s:::", host, port, dbname);
@@ -2274,26 +6315,91 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
     p->connection =
         cci_connect_with_url_ex(connect_url, username, password, &cci_error);
 
+    /*
+     * There are no URL properties for these, so set them on the new
+     * connection. Autocommit and holdability are kept on the client side
+     * by CCI, and return an error code instead of filling cci_error.
+     */
+    if (p->connection >= 0) {
+        if (isolation != 0 &&
+            cci_set_isolation_level(p->connection,
+                                    (T_CCI_TRAN_ISOLATION)isolation,
+                                    &cci_error) < 0) {
+            preset = "-isolation";
+        } else if (haveLockTimeout &&
+                   cci_set_lock_timeout(p->connection, lockTimeout,
+                                        &cci_error) < 0) {
+            preset = "-locktimeout";
+        }
+
+        if (preset == NULL && autocommit >= 0) {
+            res = cci_set_autocommit(p->connection,
+                                     autocommit ? CCI_AUTOCOMMIT_TRUE
+                                                : CCI_AUTOCOMMIT_FALSE);
+            if (res < 0) {
+                preset = "-autocommit";
+            }
+        }
+
+        if (preset == NULL && holdable >= 0) {
+            res = cci_set_holdability(p->connection, holdable);
+            if (res < 0) {
+                preset = "-holdable";
+            }
+        }
+
+        if (preset != NULL) {
+            T_CCI_ERROR disconnect_error;
+
+            if (res < 0 &&
+                cci_get_err_msg(res, cci_error.err_msg,
+                                (int)sizeof(cci_error.err_msg)) < 0) {
+                snprintf(cci_error.err_msg, sizeof(cci_error.err_msg),
+                         "error %d", res);
+            }
+
+            cci_disconnect(p->connection, &disconnect_error);
+            p->connection = -1;
+        }
+    }
+
     if (p->connection < 0) {
         p->connection = 0;
 
         /*
          * It is a problem for me. Could I need to unload here?
          */
-        Tcl_MutexLock(&cubridMutex);
-        if (--cubridRefCount == 0) {
-            Tcl_FSUnloadFile(NULL, cubridLoadHandle);
-            cubridLoadHandle = NULL;
-        }
-        Tcl_MutexUnlock(&cubridMutex);
+        CubridLibraryRelease();
 
         if (p)
             Tcl_Free((char *)p);
-        Tcl_SetResult(interp, "Connect CUBRID fail", NULL);
+        if (preset != NULL) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("%s: %s", preset,
+                                                   cci_error.err_msg));
+        } else {
+            Tcl_SetResult(interp, "Connect CUBRID fail", NULL);
+        }
         return TCL_ERROR;
     }
 
     p->interp = interp;
+    Tcl_InitHashTable(&p->schemaCache, TCL_STRING_KEYS);
+    Tcl_InitHashTable(&p->pageCache, TCL_STRING_KEYS);
+    p->txDepth = 0;
+    p->detached = 0;
+    p->stmts = NULL;
+    p->autocommit =
+        (cci_get_autocommit(p->connection) == CCI_AUTOCOMMIT_TRUE);
+    p->isolation = isolation;
+    p->lockTimeout = lockTimeout;
+    p->haveLockTimeout = haveLockTimeout;
+    p->holdable = cci_get_holdability(p->connection);
+    if (p->holdable < 0) {
+        p->holdable = 0;
+    }
+    p->bitFormat = bitFormat;
+    p->lobFormat = lobFormat;
+    p->maxRows = maxRows;
 
     zArg = Tcl_GetStringFromObj(objv[1], 0);
     Tcl_CreateObjCommand(interp, zArg, DbObjCmd, (char *)p, DbDeleteCmd);
@@ -2301,6 +6407,409 @@ static int CUBRID_MAIN(void *cd, Tcl_Interp *interp, int objc,
     return TCL_OK;
 }
 
+/*
+ * Close the connections that were detached and never attached again, when
+ * the process exits: their statements, the connection, and the library
+ * reference each of them holds.
+ */
+static void CubridDetachedExit(ClientData clientData) {
+    Tcl_HashSearch search;
+    Tcl_HashEntry *entry;
+    CubridDetached *record;
+    CUBRIDDATA *pDb;
+    int i;
+
+    Tcl_MutexLock(&detachMutex);
+    if (!detachedInitialized) {
+        Tcl_MutexUnlock(&detachMutex);
+        return;
+    }
+
+    for (entry = Tcl_FirstHashEntry(&detachedTable, &search); entry != NULL;
+         entry = Tcl_NextHashEntry(&search)) {
+        record = (CubridDetached *)Tcl_GetHashValue(entry);
+        pDb = record->pDb;
+
+        /*
+         * The statements have no command or hash entry left, so the
+         * delete procs only free them.
+         */
+        pDb->detached = 0;
+        while (pDb->stmts != NULL) {
+            StmtDeleteCmd(pDb->stmts);
+        }
+        DbDeleteCmd(pDb);
+
+        for (i = 0; i < record->stmtCount; i++) {
+            ckfree(record->stmtNames[i]);
+        }
+        if (record->stmtNames) {
+            ckfree((char *)record->stmtNames);
+        }
+        ckfree((char *)record);
+    }
+
+    Tcl_DeleteHashTable(&detachedTable);
+    detachedInitialized = 0;
+    Tcl_MutexUnlock(&detachMutex);
+}
+
+/*
+ * cubrid::detach HANDLE
+ *
+ * Take a connection and its statements out of this interpreter and thread.
+ * The commands are deleted, the connection stays open, and the returned
+ * token can be given to cubrid::attach in any thread.
+ */
+static int CUBRID_DETACH(void *cd, Tcl_Interp *interp, int objc,
+                         Tcl_Obj *const *objv) {
+    Tcl_CmdInfo info;
+    CUBRIDDATA *pDb;
+    CubridDetached *record;
+    CUBRIDStmt *pStmt;
+    Tcl_HashEntry *entry;
+    char token[16 + TCL_INTEGER_SPACE];
+    const char *name;
+    int isNew;
+    int count;
+
+    if (objc != 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "HANDLE");
+        return TCL_ERROR;
+    }
+
+    if (!Tcl_GetCommandInfo(interp, Tcl_GetString(objv[1]), &info) ||
+        info.objProc != DbObjCmd) {
+        Tcl_AppendResult(interp, "invalid handle ", Tcl_GetString(objv[1]),
+                         (char *)0);
+        return TCL_ERROR;
+    }
+
+    pDb = (CUBRIDDATA *)info.objClientData;
+    if (pDb->txDepth > 0) {
+        Tcl_SetResult(interp,
+                      (char *)"cannot detach a connection inside a transaction",
+                      NULL);
+        return TCL_ERROR;
+    }
+
+    /*
+     * Tcl_Obj values belong to the thread that made them, and so do the
+     * locators: they cannot read through a connection another thread
+     * uses.
+     */
+    CubridSchemaInvalidate(pDb);
+    CubridLobConnClose(pDb);
+
+    record = (CubridDetached *)ckalloc(sizeof(CubridDetached));
+    record->pDb = pDb;
+    record->stmtCount = 0;
+    record->stmtNames = NULL;
+
+    count = 0;
+    for (pStmt = pDb->stmts; pStmt != NULL; pStmt = pStmt->next) {
+        count++;
+    }
+
+    if (count > 0) {
+        record->stmtNames = (char **)ckalloc(sizeof(char *) * count);
+    }
+
+    /*
+     * With detached set, deleting the statement commands keeps the
+     * statements on pDb->stmts.
+     */
+    pDb->detached = 1;
+    for (pStmt = pDb->stmts; pStmt != NULL; pStmt = pStmt->next) {
+        name = Tcl_GetCommandName(interp, pStmt->cmd);
+        record->stmtNames[record->stmtCount++] = strcpy(
+            (char *)ckalloc(strlen(name) + 1), name);
+
+        Tcl_DeleteCommandFromToken(pStmt->interp, pStmt->cmd);
+    }
+
+    pDb->interp = NULL;
+    Tcl_DeleteCommand(interp, Tcl_GetString(objv[1]));
+
+    Tcl_MutexLock(&detachMutex);
+    if (!detachedInitialized) {
+        Tcl_InitHashTable(&detachedTable, TCL_STRING_KEYS);
+        Tcl_CreateExitHandler(CubridDetachedExit, NULL);
+        detachedInitialized = 1;
+    }
+    sprintf(token, "cubrid_conn%d", detachedCounter++);
+    entry = Tcl_CreateHashEntry(&detachedTable, token, &isNew);
+    Tcl_SetHashValue(entry, record);
+    Tcl_MutexUnlock(&detachMutex);
+
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(token, -1));
+    return TCL_OK;
+}
+
+/*
+ * The first name of an attach that is taken in this interpreter, by a
+ * command or a statement of this thread, or NULL if all are free.
+ */
+static const char *CubridAttachClash(Tcl_Interp *interp,
+                                     ThreadSpecificData *tsdPtr,
+                                     CubridDetached *record,
+                                     const char *handleName) {
+    Tcl_CmdInfo info;
+    const char *name;
+    int i;
+
+    if (Tcl_GetCommandInfo(interp, handleName, &info)) {
+        return handleName;
+    }
+
+    for (i = 0; i < record->stmtCount; i++) {
+        name = record->stmtNames[i];
+        if (strcmp(name, handleName) == 0 ||
+            Tcl_GetCommandInfo(interp, name, &info) ||
+            Tcl_FindHashEntry(tsdPtr->cubrid_hashtblPtr, name) != NULL) {
+            return name;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * cubrid::attach token ?newName?
+ *
+ * Create the commands of a detached connection and its statements in this
+ * interpreter. Statements keep their names, the connection is named
+ * newName or token. Returns the connection name.
+ */
+static int CUBRID_ATTACH(void *cd, Tcl_Interp *interp, int objc,
+                         Tcl_Obj *const *objv) {
+    ThreadSpecificData *tsdPtr;
+    CubridDetached *record = NULL;
+    CUBRIDDATA *pDb;
+    CUBRIDStmt *pStmt;
+    Tcl_HashEntry *entry;
+    const char *handleName;
+    const char *name;
+    int isNew;
+    int i;
+
+    if (objc != 2 && objc != 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "token ?newName?");
+        return TCL_ERROR;
+    }
+
+    handleName = Tcl_GetString(objv[objc - 1]);
+    tsdPtr = CubridGetThreadData();
+
+    /*
+     * Check every name before taking the token, so a clash leaves it for
+     * another try.
+     */
+    Tcl_MutexLock(&detachMutex);
+    entry = NULL;
+    if (detachedInitialized) {
+        entry = Tcl_FindHashEntry(&detachedTable, Tcl_GetString(objv[1]));
+    }
+    if (entry == NULL) {
+        Tcl_MutexUnlock(&detachMutex);
+        Tcl_AppendResult(interp, "invalid token ", Tcl_GetString(objv[1]),
+                         (char *)0);
+        return TCL_ERROR;
+    }
+    record = (CubridDetached *)Tcl_GetHashValue(entry);
+
+    name = CubridAttachClash(interp, tsdPtr, record, handleName);
+    if (name != NULL) {
+        Tcl_MutexUnlock(&detachMutex);
+        Tcl_AppendResult(interp, "command \"", name, "\" already exists",
+                         (char *)0);
+        return TCL_ERROR;
+    }
+
+    Tcl_DeleteHashEntry(entry);
+    Tcl_MutexUnlock(&detachMutex);
+
+    pDb = record->pDb;
+    pDb->detached = 0;
+    pDb->interp = interp;
+
+    for (i = 0, pStmt = pDb->stmts; pStmt != NULL;
+         i++, pStmt = pStmt->next) {
+        entry = Tcl_CreateHashEntry(tsdPtr->cubrid_hashtblPtr,
+                                    record->stmtNames[i], &isNew);
+        Tcl_SetHashValue(entry, pStmt);
+        pStmt->entry = entry;
+
+        pStmt->interp = interp;
+        pStmt->cmd = Tcl_CreateObjCommand(interp, record->stmtNames[i],
+                                          (Tcl_ObjCmdProc *)CUBRID_STMT,
+                                          (char *)pStmt, StmtDeleteCmd);
+        ckfree(record->stmtNames[i]);
+    }
+
+    if (record->stmtNames) {
+        ckfree((char *)record->stmtNames);
+    }
+    ckfree((char *)record);
+
+    Tcl_CreateObjCommand(interp, handleName, DbObjCmd, (char *)pDb,
+                         DbDeleteCmd);
+
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(handleName, -1));
+    return TCL_OK;
+}
+
+/*
+ * cubrid::allocstats
+ *
+ * Counters of the CCI allocator hooks (all zero with the system
+ * allocator, which is not hooked).
+ */
+static int CUBRID_ALLOCSTATS(void *cd, Tcl_Interp *interp, int objc,
+                             Tcl_Obj *const *objv) {
+    Tcl_Obj *resultObj;
+
+    if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, 0);
+        return TCL_ERROR;
+    }
+
+    resultObj = Tcl_NewDictObj();
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("allocator", -1),
+                   Tcl_NewStringObj(cubridAllocMode < 0
+                                        ? "none"
+                                        : cubridAllocModes[cubridAllocMode],
+                                    -1));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("malloc", -1),
+                   Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.mallocs)));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("calloc", -1),
+                   Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.callocs)));
+    Tcl_DictObjPut(
+        NULL, resultObj, Tcl_NewStringObj("realloc", -1),
+        Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.reallocs)));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("free", -1),
+                   Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.frees)));
+    Tcl_DictObjPut(
+        NULL, resultObj, Tcl_NewStringObj("poolhits", -1),
+        Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.poolHits)));
+    Tcl_DictObjPut(NULL, resultObj, Tcl_NewStringObj("inuse", -1),
+                   Tcl_NewWideIntObj(CubridStatGet(&cubridAllocStats.inUse)));
+
+    Tcl_SetObjResult(interp, resultObj);
+    return TCL_OK;
+}
+
+/*
+ * cubrid::lob size locator
+ * cubrid::lob read locator offset length
+ *
+ * The size of a LOB fetched with -lobformat locator, or length bytes of
+ * it from offset (0 based), as a bytearray for a BLOB and a string for a
+ * CLOB.
+ */
+static int CUBRID_LOB(void *cd, Tcl_Interp *interp, int objc,
+                      Tcl_Obj *const *objv) {
+    CubridLob *lobPtr;
+    Tcl_Obj *resultPtr;
+    Tcl_WideInt offset, length;
+    long long size, res;
+    char *buf;
+    int choice;
+
+    static const char *LOB_strs[] = {"size", "read", 0};
+    enum LOB_enum { LOB_SIZE, LOB_READ };
+
+    (void)cd;
+
+    if (objc < 3) {
+        Tcl_WrongNumArgs(interp, 1, objv, "option locator ?offset length?");
+        return TCL_ERROR;
+    }
+
+    if (Tcl_GetIndexFromObj(interp, objv[1], LOB_strs, "option", 0,
+                            &choice)) {
+        return TCL_ERROR;
+    }
+
+    if (objv[2]->typePtr != &cubridLobType) {
+        Tcl_SetResult(interp, (char *)"value is not a lob locator", NULL);
+        return TCL_ERROR;
+    }
+    lobPtr = CubridLobRep(objv[2]);
+
+    size = CubridLobSize(lobPtr);
+    if (size < 0) {
+        Tcl_SetResult(interp, (char *)"get lob size failed", NULL);
+        return TCL_ERROR;
+    }
+
+    switch ((enum LOB_enum)choice) {
+    case LOB_SIZE:
+        if (objc != 3) {
+            Tcl_WrongNumArgs(interp, 2, objv, "locator");
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, Tcl_NewWideIntObj((Tcl_WideInt)size));
+        break;
+
+    case LOB_READ:
+        if (objc != 5) {
+            Tcl_WrongNumArgs(interp, 2, objv, "locator offset length");
+            return TCL_ERROR;
+        }
+
+        if (Tcl_GetWideIntFromObj(interp, objv[3], &offset) != TCL_OK ||
+            Tcl_GetWideIntFromObj(interp, objv[4], &length) != TCL_OK) {
+            return TCL_ERROR;
+        }
+
+        if (offset < 0 || length < 0) {
+            Tcl_SetResult(interp, (char *)"offset and length must be >= 0",
+                          NULL);
+            return TCL_ERROR;
+        }
+
+        if (offset > size) {
+            offset = size;
+        }
+        if (length > size - offset) {
+            length = size - offset;
+        }
+
+        if (lobPtr->type == CCI_U_TYPE_BLOB) {
+            resultPtr = Tcl_NewByteArrayObj(NULL, 0);
+            buf = (char *)Tcl_SetByteArrayLength(resultPtr, (Tcl_Size)length);
+            res = CubridLobRead(lobPtr, offset, length, buf);
+            if (res >= 0) {
+                Tcl_SetByteArrayLength(resultPtr, (Tcl_Size)res);
+            }
+        } else {
+            buf = ckalloc((size_t)length + 1);
+            res = CubridLobRead(lobPtr, offset, length, buf);
+            resultPtr = res >= 0 ? Tcl_NewStringObj(buf, (Tcl_Size)res) : NULL;
+            ckfree(buf);
+        }
+
+        if (res < 0) {
+            if (resultPtr) {
+                Tcl_IncrRefCount(resultPtr);
+                Tcl_DecrRefCount(resultPtr);
+            }
+            Tcl_SetResult(interp,
+                          res == -2 ? (char *)"lob connection is closed"
+                                    : (char *)"read lob failed",
+                          NULL);
+            return TCL_ERROR;
+        }
+
+        Tcl_SetObjResult(interp, resultPtr);
+        break;
+    }
+
+    return TCL_OK;
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -2321,27 +6830,19 @@ int Cubrid_Init(Tcl_Interp *interp) {
     if (Tcl_InitStubs(interp, TCL_VERSION, 0) == NULL) {
         return TCL_ERROR;
     }
+    if (Tcl_OOInitStubs(interp) == NULL) {
+        return TCL_ERROR;
+    }
     if (Tcl_PkgProvide(interp, PACKAGE_NAME, PACKAGE_VERSION) != TCL_OK) {
         return TCL_ERROR;
     }
 
     /*
      *   Tcl_GetThreadData handles the auto-initialization of all data in
-     *  the ThreadSpecificData to NULL at first time.
+     *  the ThreadSpecificData to NULL at first time. The data is only used
+     *  by this thread, so no lock is needed.
      */
-    Tcl_MutexLock(&myMutex);
-    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)Tcl_GetThreadData(
-        &dataKey, sizeof(ThreadSpecificData));
-
-    if (tsdPtr->initialized == 0) {
-        tsdPtr->initialized = 1;
-        tsdPtr->cubrid_hashtblPtr =
-            (Tcl_HashTable *)ckalloc(sizeof(Tcl_HashTable));
-        Tcl_InitHashTable(tsdPtr->cubrid_hashtblPtr, TCL_STRING_KEYS);
-
-        tsdPtr->stmt_count = 0;
-    }
-    Tcl_MutexUnlock(&myMutex);
+    CubridGetThreadData();
 
     /* Add a thread exit handler to delete hash table */
     Tcl_CreateThreadExitHandler(CUBRID_Thread_Exit, (ClientData)NULL);
@@ -2349,5 +6850,24 @@ int Cubrid_Init(Tcl_Interp *interp) {
     Tcl_CreateObjCommand(interp, "cubrid", (Tcl_ObjCmdProc *)CUBRID_MAIN,
                          (ClientData)NULL, (Tcl_CmdDeleteProc *)NULL);
 
+    Tcl_CreateObjCommand(interp, "::cubrid::resultset_methods",
+                         (Tcl_ObjCmdProc *)CUBRID_RESULTSET_METHODS,
+                         (ClientData)NULL, (Tcl_CmdDeleteProc *)NULL);
+
+    Tcl_CreateObjCommand(interp, "::cubrid::detach",
+                         (Tcl_ObjCmdProc *)CUBRID_DETACH, (ClientData)NULL,
+                         (Tcl_CmdDeleteProc *)NULL);
+
+    Tcl_CreateObjCommand(interp, "::cubrid::attach",
+                         (Tcl_ObjCmdProc *)CUBRID_ATTACH, (ClientData)NULL,
+                         (Tcl_CmdDeleteProc *)NULL);
+
+    Tcl_CreateObjCommand(interp, "::cubrid::lob", (Tcl_ObjCmdProc *)CUBRID_LOB,
+                         (ClientData)NULL, (Tcl_CmdDeleteProc *)NULL);
+
+    Tcl_CreateObjCommand(interp, "::cubrid::allocstats",
+                         (Tcl_ObjCmdProc *)CUBRID_ALLOCSTATS, (ClientData)NULL,
+                         (Tcl_CmdDeleteProc *)NULL);
+
     return TCL_OK;
 }
@@ -111,8 +111,8 @@ package provide tdbc::cubrid 0.10.0
                     }
                     rep - repe - repea - repeat - repeata - repeatab -
                     repeatabl - repeatable - repeatabler - repeatablere -
-                    repeatablerea - repeatablread {
-                       [namespace current]::DB setIsolationLevel repeatablread
+                    repeatablerea - repeatableread {
+                       [namespace current]::DB setIsolationLevel repeatableread
                     }
                     s - se - ser - seri - seria - serial - seriali -
                     serializ - serializa - serializab - serializabl -
@@ -161,132 +161,42 @@ package provide tdbc::cubrid 0.10.0
         next
     }
 
+    # The metadata methods use HANDLE schema, which reads the catalog
+    # through cci_schema_info and caches the result on the connection.
     method tables {{pattern %}} {
-        set retval {}
-
-        # I only know how to get user table name list
-        set stmt [[namespace current]::DB prepare "SELECT class_name name \
-                   FROM db_class WHERE class_name like '$pattern' AND \
-                   is_system_class = 'NO'"]
-
-        $stmt execute
-        while {[$stmt cursor 1 CURRENT] != 0} {
-            set row [$stmt fetch_row_dict]
-            dict set row name [string tolower [dict get $row name]]
-            dict set retval [dict get $row name] $row
-        }
-        $stmt close
-
-        return $retval
+        return [[namespace current]::DB schema tables $pattern]
     }
 
     method columns {table {pattern %}} {
-        set retval {}
-
-        # Setup our pattern
-        set pattern [string map [list \
-                                     * {[*]} \
-                                     ? {[?]} \
-                                     \[ \\\[ \
-                                     \] \\\[ \
-                                     _ ? \
-                                     % *] [string tolower $pattern]]
-
-        # I only know how to get column name list
-        set stmt [[namespace current]::DB prepare "SELECT a.attr_name \
-                   name FROM db_attribute as a WHERE \
-                   class_name = '$table' ORDER BY def_order"]
-
-        $stmt execute
-
-        while {[$stmt cursor 1 CURRENT] != 0} {
-            set row [$stmt fetch_row_dict]
-            dict set row name [string tolower [dict get $row name]]
-
-            set column_name [dict get $row name]
-            if {![string match $pattern $column_name]} {
-                continue
-            }
-
-            dict set retval [dict get $row name] $row
-        }
-        $stmt close
-
-        return $retval
+        return [[namespace current]::DB schema columns $table \
+                    [string tolower $pattern]]
     }
 
     method primarykeys {table} {
-        set retval {}
-        set stmt [[namespace current]::DB prepare "SELECT index_name name FROM \
-            db_index WHERE class_name = '$table' AND is_primary_key = 'YES'"]
-        $stmt execute
-
-        set retval [dict create]
-
-        # Add table name
-        dict set retval tableName $table
-        while {[$stmt cursor 1 CURRENT] != 0} {
-            set row [$stmt fetch_row_dict]
-            dict set row name [string tolower [dict get $row name]]
-
-            # Get key name
-            set key_name [dict get $row name]
-            dict set retval keyName $key_name
-        }
-        $stmt close
-
-        return $retval
+        return [[namespace current]::DB schema primarykeys $table]
     }
 
     method foreignkeys {args} {
         set length [llength $args]
-        set retval {}
-        set ftable ""
 
-        if { $length != 2 || $length%2 != 0} {
+        if {$length == 0 || $length > 4 || $length%2 != 0} {
             return -code error \
             -errorcode [list TDBC GENERAL_ERROR HY000 \
                     CUBRID WRONGNUMARGS] \
             "wrong # args: should be \
-             [lrange [info level 0] 0 1] -foreign tableName"
-
-            return $retval
+             [lrange [info level 0] 0 1] ?-primary table? ?-foreign table?"
         }
 
-        # I only know how to list foreign keys of a table, maybe not correct
         foreach {option table} $args {
-            if {[string compare $option "-foreign"]==0} {
-                set ftable $table
-            } else {
-                return $retval
+            if {$option ni {-primary -foreign}} {
+                return -code error \
+                -errorcode [list TDBC GENERAL_ERROR HY000 \
+                        CUBRID BADOPTION] \
+                "bad option \"$option\": must be -primary or -foreign"
             }
         }
 
-        set sql "SELECT index_name name FROM db_index WHERE \
-                  class_name = '$ftable' AND is_foreign_key = 'YES'"
-        set stmt [[namespace current]::DB prepare $sql]
-        $stmt execute
-
-        set retval [dict create]
-        set vallist [list]
-
-        # Add table name
-        dict set retval tableName $ftable
-        while {[$stmt cursor 1 CURRENT] != 0} {
-            set row [$stmt fetch_row_dict]
-            dict set row name [string tolower [dict get $row name]]
-
-            # Get key name
-            set key_name [dict get $row name]
-            lappend vallist $key_name
-        }
-
-        if {[llength $vallist] != 0} {
-            dict set retval keyName $vallist
-        }
-        $stmt close
-
-        return $retval
+        return [[namespace current]::DB schema foreignkeys {*}$args]
     }
 
     # The 'prepareCall' method gives a portable interface to prepare
@@ -319,6 +229,12 @@ package provide tdbc::cubrid 0.10.0
         [namespace current]::DB setAutocommit 1
     }
 
+    # The 'transaction' method runs a script in a transaction with
+    # HANDLE transaction, nested calls use savepoints.
+    method transaction {script} {
+        uplevel 1 [list [namespace current]::DB transaction $script]
+    }
+
     method prepare {sqlCode} {
         set result [next $sqlCode]
         return $result
@@ -344,20 +260,17 @@ package provide tdbc::cubrid 0.10.0
 
     superclass ::tdbc::statement
 
-    variable Params db sql stmt
+    variable Params db sql stmt names bindList
 
     constructor {connection sqlcode} {
         next
         set Params {}
         set db [$connection getDBhandle]
         set sql {}
+        set names {}
         foreach token [::tdbc::tokenize $sqlcode] {
-
-            # I have no idea how to get params meta here,
-            # just give a default value.
             if {[string index $token 0] in {$ : @}} {
-                dict set Params [string range $token 1 end] \
-                    {type varchar direction in}
+                lappend names [string range $token 1 end]
 
                 append sql "?"
                 continue
@@ -367,6 +280,29 @@ package provide tdbc::cubrid 0.10.0
         }
 
         set stmt [$db prepare $sql]
+
+        # Take the parameter types the server reports for each marker,
+        # the first marker of a name decides its type.
+        set types [$stmt paramtypes]
+        foreach name $names type $types {
+            if {$name eq "" || [dict exists $Params $name]} {
+                continue
+            }
+            if {$type eq ""} {
+                set type varchar
+            }
+            dict set Params $name [list type $type direction in]
+        }
+        my BuildBindList
+    }
+
+    # One "name type" pair per ? marker, in marker order, for
+    # STMT_HANDLE bind_vars.
+    method BuildBindList {} {
+        set bindList {}
+        foreach name $names {
+            lappend bindList [list $name [dict get $Params $name type]]
+        }
     }
 
     forward resultSetCreate ::tdbc::cubrid::resultset create
@@ -421,18 +357,21 @@ package provide tdbc::cubrid 0.10.0
         if {$length > $count} {
             set type [lindex $args $count]
 
-            # Only accept these types
+            # Only accept these types, a collection may name its element
+            # type (set:integer)
             if {$type in {char varchar bit varbit numeric integer smallint \
                           real float double monetary date time timestamp \
                           timestamptz timestampltz bigint datetime datetimetz \
                           datetimeltz clob blob set multiset sequence \
-                          enum json null}} {
+                          enum json null} ||
+                [regexp {^(set|multiset|sequence):[a-z]+$} $type]} {
                 dict set value type $type
             }
         }
 
         # Skip other parameters and setup
         dict set Params $parameter $value
+        my BuildBindList
     }
 
     method getStmthandle {} {
@@ -443,6 +382,10 @@ package provide tdbc::cubrid 0.10.0
         return $sql
     }
 
+    method getBindList {} {
+        return $bindList
+    }
+
     method getRowCount {} {
        return [$db row_count]
     }
@@ -464,7 +407,7 @@ package provide tdbc::cubrid 0.10.0
     superclass ::tdbc::resultset
 
     variable -set {*}{
-        -stmt -sql -results -params -RowCount -columns
+        -stmt -sql -results -params -columns
     }
 
     constructor {statement args} {
@@ -473,45 +416,16 @@ package provide tdbc::cubrid 0.10.0
         set -params  [$statement params]
         set -sql [$statement getSql]
         set -results {}
-        set -RowCount 0
 
         if {[llength $args] == 0} {
-            set keylist [dict keys ${-params}]
-            set count 1
-
-            foreach mykey $keylist {
-
-                if {[info exists ::$mykey] == 1} {
-                    upvar 1 $mykey mykey1
-                    set type [dict get [dict get ${-params} $mykey] type]
-
-                    catch {${-stmt} bind $count $type $mykey1}
-                }
-
-                incr count 1
-            }
-            ${-stmt} execute
-            set -RowCount [$statement getRowCount]
+            # Parameters are variables in the caller's frame
+            uplevel 1 [list ${-stmt} bind_vars [$statement getBindList]]
+            my attach ${-stmt} [${-stmt} execute -all -count]
         } elseif {[llength $args] == 1} {
             # If the dict parameter is supplied, it is searched for a key
             # whose name matches the name of the bound variable
-            set -paramDict [lindex $args 0]
-
-            set keylist [dict keys ${-params}]
-            set count 1
-
-            foreach mykey $keylist {
-
-                if {[catch {set bound [dict get ${-paramDict} $mykey]}]==0} {
-                    set type [dict get [dict get ${-params} $mykey] type]
-
-                    catch {${-stmt} bind $count $type $bound}
-                }
-
-                incr count 1
-            }
-            ${-stmt} execute
-            set -RowCount [$statement getRowCount]
+            ${-stmt} bind_vars [$statement getBindList] [lindex $args 0]
+            my attach ${-stmt} [${-stmt} execute -all -count]
         } else {
             return -code error \
             -errorcode [list TDBC GENERAL_ERROR HY000 \
@@ -527,74 +441,10 @@ package provide tdbc::cubrid 0.10.0
         return ${-columns}
     }
 
-    method nextresults {} {
-        set have 0
-
-        # Is it really OK? check current cursor status
-        if {[catch {set have [${-stmt} cursor 0 CURRENT]}]} {
-	    return 0
-        }
-
-        return $have
-    }
-
-    method nextlist var {
-        upvar 1 $var row
-        set row {}
-        set result 0
-
-        variable mylist
-
-        if {[catch {set result [${-stmt} cursor 1 CURRENT]}]} {
-	    return 0
-        }
-
-        if {$result == 0} {
-            return 0
-        }
-
-        if { [catch {set mylist [ ${-stmt} fetch_row_list ]}] } {
-            return 0
-        }
-
-        if {[llength $mylist] == 0} {
-            return 0
-        }
-
-        set row $mylist
-        return 1
-    }
-
-    method nextdict var {
-        upvar 1 $var row
-        set row {}
-        set result 0
-
-        variable mydict
-
-        if {[catch {set result [${-stmt} cursor 1 CURRENT]}]} {
-	    return 0
-        }
-
-        if {$result == 0} {
-            return 0
-        }
-
-        if { [catch {set mydict [ ${-stmt} fetch_row_dict ]}] } {
-            return 0
-        }
-
-        if {[dict size $mydict] == 0} {
-            return 0
-        }
-
-        set row $mydict
-        return 1
-    }
-
-    # Return the number of rows affected by a statement
-    method rowcount {} {
-        return ${-RowCount}
-    }
+    # The nextlist, nextdict, nextresults and rowcount methods are
+    # implemented in C by the cubrid package, so fetching a row goes
+    # through the same decode path as STMT_HANDLE fetch_row_list/dict.
 
 }
+
+::cubrid::resultset_methods ::tdbc::cubrid::resultset